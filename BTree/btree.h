@@ -0,0 +1,447 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+/**
+  * -------------------------------------------------------------------------------------------------------------
+  * Class: BTree<T>
+  * -------------------------------------------------------------------------------------------------------------
+  * A B-tree which consists of BTreeNode<T> objects. Each node keeps many sorted data objects in a contiguous
+  * array. Compared to the BinaryTree<T> there are much less nodes and the tree is much flatter. A lookup
+  * needs a few node visits instead of one heap object per level. The tree is always balanced. All leaves
+  * have the same depth. Insert and find are O(log n).
+  * Operators to overload in T:
+  * - operator <, must return true if user data object is lesser then another.
+  * - operator >, must return true if this user data object is greater than another one.
+  * - operator <<, is needed for behaviour KeepEqual. The user data objects must be united.
+  * And a 'toString()' method for toString().
+  *
+  * EqualBehaviour
+  * ---------------
+  * The same as in BinaryTree<T>.
+  *
+  * EqualBehaviour::EqualToLesser
+  *     A new equal object is placed before the equal objects in the tree.
+  * EqualBehaviour::KeepEqual
+  *     The new object is united with the equal object in the tree.
+  * EqualBehaviour::EqualToGreater
+  *     A new equal object is placed after the equal objects in the tree.
+  *
+  * Insert
+  * ------
+  * Insert walks down from root to a leave. Each full node on the way is split before it is entered.
+  * So the new object always fits into the leave and no node has to be revisited. insert(T&&) moves the
+  * object into the tree. Objects are moved within and between nodes.
+  *
+  * Iteration
+  * ---------
+  * begin() and end() return iterators which walk through all objects in ascending order. An iterator
+  * keeps the path from root to its position. The tree must not be changed while iterating.
+  */
+
+#include <btreenode.h>
+#include <QString>
+#include <QVarLengthArray>
+#include <utility>
+
+
+template<class T>
+class BTree
+{
+public:
+    enum EqualBehaviour { EqualToLesser = -1, KeepEqual = 0, EqualToGreater = 1 };
+
+    class Iterator
+    {
+        friend class BTree<T>;
+
+    public:
+        const T& operator * () const                    { return m_path.last().pNode->key(m_path.last().index); }
+        const T* operator -> () const                   { return &operator *(); }
+        Iterator& operator ++ ();
+        bool operator == (const Iterator& rhs) const;
+        bool operator != (const Iterator& rhs) const    { return ! operator ==(rhs); }
+
+    private:
+        struct Position {
+            const BTreeNode<T>* pNode;
+            int index;
+        };
+
+        void descendLeft(const BTreeNode<T>* pNode);
+        void skipVisited();
+
+        QVarLengthArray<Position, 16> m_path;
+    };
+
+    // Constructor
+    BTree() :
+        m_pRoot(0),
+        m_size(0),
+        m_equalBehaviour(EqualToLesser)
+    {
+
+    }
+
+    // Destructor
+    ~BTree()
+    {
+        clear();
+    }
+
+    // Public member functions.
+    void insert(const T& data)                                  { insertValue(data); }
+    void insert(T&& data)                                       { insertValue(std::move(data)); }
+    const T* find(const T& data) const;
+    void clear();
+    QString toString() const;
+    int size() const                                            { return m_size; }
+    bool isEmpty() const                                        { return m_size == 0; }
+    void setEqualBehaviour(const EqualBehaviour behaviour)      { m_equalBehaviour = behaviour; }
+    EqualBehaviour equalBehaviour() const                       { return m_equalBehaviour; }
+    Iterator begin() const;
+    Iterator end() const                                        { return Iterator(); }
+
+private:
+    BTreeNode<T>* m_pRoot;
+    int m_size;
+    EqualBehaviour m_equalBehaviour;
+
+    // Private member functions.
+    static BTreeInnerNode<T>* inner(BTreeNode<T>* pNode)        { return static_cast<BTreeInnerNode<T>*>(pNode); }
+    static bool isEqual(const T& data, const T& key)            { return ! (data < key) && ! (data > key); }
+    int lowerBound(const BTreeNode<T>* pNode, const T& data) const;
+    int upperBound(const BTreeNode<T>* pNode, const T& data) const;
+    int insertPosition(const BTreeNode<T>* pNode, const T& data) const;
+    void splitChild(BTreeInnerNode<T>* pParent, const int index);
+    template<class Value>
+    void insertValue(Value&& data);
+};
+
+
+
+/**
+ * Inserts a copy of data into the tree. Full nodes on the path down to
+ * the leave are split. If the behaviour is KeepEqual and an equal object
+ * is found on the way then data is united with this object.
+ * Keys are moved within nodes. An rvalue data object is moved into the tree.
+ * @param data      The data object to insert.
+ */
+template<class T>
+template<class Value>
+void BTree<T>::insertValue(Value &&data)
+{
+    if (m_pRoot == 0) {
+        m_pRoot = new BTreeNode<T>();
+    }
+    if (m_pRoot->isFull()) {
+        BTreeInnerNode<T>* pNewRoot = new BTreeInnerNode<T>();
+        pNewRoot->m_children[0] = m_pRoot;
+        m_pRoot = pNewRoot;
+        splitChild(pNewRoot, 0);
+    }
+    BTreeNode<T>* pNode = m_pRoot;
+    while (true) {
+        int position = insertPosition(pNode, data);
+        if (m_equalBehaviour == KeepEqual && position < pNode->m_count && isEqual(data, pNode->key(position))) {
+            pNode->key(position) << data;
+            return;
+        }
+        if (pNode->isLeaf()) {
+            pNode->insertKey(position, std::forward<Value>(data));
+            ++m_size;
+            return;
+        }
+        BTreeInnerNode<T>* pInnerNode = inner(pNode);
+        if (pInnerNode->m_children[position]->isFull()) {
+            splitChild(pInnerNode, position);
+            // The median of the child is now at position. Decide again.
+            position = insertPosition(pNode, data);
+            if (m_equalBehaviour == KeepEqual && position < pNode->m_count && isEqual(data, pNode->key(position))) {
+                pNode->key(position) << data;
+                return;
+            }
+        }
+        pNode = pInnerNode->m_children[position];
+    }
+}
+
+/**
+ * Find an object in the tree which is equal to data. The object can not
+ * be changed through the pointer. A change could break the order of the
+ * tree.
+ * @param data      A data object with content to search for in the tree.
+ * @return          A pointer to the object in the tree or NULL.
+ */
+template<class T>
+const T *BTree<T>::find(const T &data) const
+{
+    BTreeNode<T>* pNode = m_pRoot;
+    while (pNode) {
+        int position = lowerBound(pNode, data);
+        if (position < pNode->m_count && isEqual(data, pNode->key(position))) {
+            return &pNode->key(position);
+        }
+        if (pNode->isLeaf()) {
+            return 0;
+        }
+        pNode = inner(pNode)->m_children[position];
+    }
+
+    return 0;
+}
+
+/**
+ * Deletes all nodes of the tree. The nodes are deleted without recursion.
+ */
+template<class T>
+void BTree<T>::clear()
+{
+    if (m_pRoot == 0) {
+        return;
+    }
+    QVarLengthArray<BTreeNode<T>*, 64> stack;
+    stack.append(m_pRoot);
+    while (! stack.isEmpty()) {
+        BTreeNode<T>* pNode = stack.last();
+        stack.removeLast();
+        if (! pNode->isLeaf()) {
+            BTreeInnerNode<T>* pInnerNode = inner(pNode);
+            for (int index=0; index<=pNode->m_count; ++index) {
+                stack.append(pInnerNode->m_children[index]);
+            }
+            delete pInnerNode;
+        } else {
+            delete pNode;
+        }
+    }
+    m_pRoot = 0;
+    m_size = 0;
+}
+
+/**
+ * Builds a string representation of the tree. Each node is a line with
+ * its objects. Children are indented below their parent node.
+ * The data T object must implement the 'toString()' method.
+ */
+template<class T>
+QString BTree<T>::toString() const
+{
+    if (m_pRoot == 0) {
+        return QString("Is empty.");
+    }
+    struct Entry {
+        const BTreeNode<T>* pNode;
+        int depth;
+    };
+    QString treeString;
+    QVarLengthArray<Entry, 64> stack;
+    Entry root = { m_pRoot, 0 };
+    stack.append(root);
+    while (! stack.isEmpty()) {
+        Entry entry = stack.last();
+        stack.removeLast();
+        treeString.append(QString(entry.depth * 5, ' ')).append(QString("["));
+        for (int index=0; index<entry.pNode->m_count; ++index) {
+            if (index > 0) {
+                treeString.append(QString(" | "));
+            }
+            treeString.append(entry.pNode->key(index).toString());
+        }
+        treeString.append(QString("]\n"));
+        if (! entry.pNode->isLeaf()) {
+            const BTreeInnerNode<T>* pInnerNode = static_cast<const BTreeInnerNode<T>*>(entry.pNode);
+            for (int index=entry.pNode->m_count; index>=0; --index) {
+                Entry child = { pInnerNode->child(index), entry.depth + 1 };
+                stack.append(child);
+            }
+        }
+    }
+
+    return treeString;
+}
+
+/**
+ * Get an iterator to the least object in the tree.
+ * @return          An iterator which is equal to end() if the tree is empty.
+ */
+template<class T>
+typename BTree<T>::Iterator BTree<T>::begin() const
+{
+    Iterator iterator;
+    if (m_size > 0) {
+        iterator.descendLeft(m_pRoot);
+    }
+
+    return iterator;
+}
+
+/**
+ * Binary search for the first key in a node which is not lesser than data.
+ * @param pNode     The node to search in.
+ * @param data      The data object to search for.
+ * @return          An index between 0 and the key count of the node.
+ */
+template<class T>
+int BTree<T>::lowerBound(const BTreeNode<T> *pNode, const T &data) const
+{
+    int first = 0;
+    int last = pNode->m_count;
+    while (first < last) {
+        int middle = (first + last) / 2;
+        if (data > pNode->key(middle)) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * Binary search for the first key in a node which is greater than data.
+ * @param pNode     The node to search in.
+ * @param data      The data object to search for.
+ * @return          An index between 0 and the key count of the node.
+ */
+template<class T>
+int BTree<T>::upperBound(const BTreeNode<T> *pNode, const T &data) const
+{
+    int first = 0;
+    int last = pNode->m_count;
+    while (first < last) {
+        int middle = (first + last) / 2;
+        if (data < pNode->key(middle)) {
+            last = middle;
+        } else {
+            first = middle + 1;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * The position of a new object in a node. A new object is placed
+ * before equal objects if behaviour is EqualToLesser and after them
+ * if it is EqualToGreater.
+ * @param pNode     The node to search in.
+ * @param data      The new data object.
+ * @return          The index of a key or a child.
+ */
+template<class T>
+int BTree<T>::insertPosition(const BTreeNode<T> *pNode, const T &data) const
+{
+    if (m_equalBehaviour == EqualToGreater) {
+        return upperBound(pNode, data);
+    }
+
+    return lowerBound(pNode, data);
+}
+
+/**
+ * Splits a full child of a node. The upper half of keys and children
+ * are moved to a new sibling node. The median key is moved up into the
+ * parent at index.
+ * @param pParent   A node which is not full.
+ * @param index     The index of the full child.
+ */
+template<class T>
+void BTree<T>::splitChild(BTreeInnerNode<T> *pParent, const int index)
+{
+    const int half = (BTreeNode<T>::MaxKeys - 1) / 2;
+    BTreeNode<T>* pChild = pParent->m_children[index];
+    BTreeNode<T>* pSibling = 0;
+    if (pChild->isLeaf()) {
+        pSibling = new BTreeNode<T>();
+    } else {
+        BTreeInnerNode<T>* pInnerSibling = new BTreeInnerNode<T>();
+        for (int position=0; position<=half; ++position) {
+            pInnerSibling->m_children[position] = inner(pChild)->m_children[half + 1 + position];
+            inner(pChild)->m_children[half + 1 + position] = 0;
+        }
+        pSibling = pInnerSibling;
+    }
+    T* pChildKeys = pChild->keys();
+    T* pSiblingKeys = pSibling->keys();
+    for (int position=0; position<half; ++position) {
+        new (pSiblingKeys + position) T(std::move(pChildKeys[half + 1 + position]));
+    }
+    pSibling->m_count = half;
+    for (int position=pParent->m_count; position>index; --position) {
+        pParent->m_children[position + 1] = pParent->m_children[position];
+    }
+    pParent->insertKey(index, std::move(pChildKeys[half]));
+    pParent->m_children[index + 1] = pSibling;
+    // The moved keys are destroyed.
+    pChild->truncate(half);
+}
+
+/**
+ * Moves the iterator to the next object in ascending order.
+ * @return          This iterator. Equal to end() after the last object.
+ */
+template<class T>
+typename BTree<T>::Iterator &BTree<T>::Iterator::operator ++()
+{
+    Position& position = m_path.last();
+    ++position.index;
+    if (! position.pNode->isLeaf()) {
+        // Objects of the child between the visited key and the next key come first.
+        const BTreeInnerNode<T>* pInnerNode = static_cast<const BTreeInnerNode<T>*>(position.pNode);
+        descendLeft(pInnerNode->child(position.index));
+        return *this;
+    }
+    skipVisited();
+
+    return *this;
+}
+
+/**
+ * Two iterators are equal if they point to the same object. All
+ * iterators behind the last object are equal.
+ * @param rhs       Another iterator.
+ * @return          True if equal.
+ */
+template<class T>
+bool BTree<T>::Iterator::operator ==(const BTree<T>::Iterator &rhs) const
+{
+    if (m_path.isEmpty() || rhs.m_path.isEmpty()) {
+        return m_path.isEmpty() == rhs.m_path.isEmpty();
+    }
+
+    return m_path.last().pNode == rhs.m_path.last().pNode && m_path.last().index == rhs.m_path.last().index;
+}
+
+/**
+ * Private
+ * Walks down to the least object of a subtree and keeps the path.
+ * @param pNode     The root of the subtree.
+ */
+template<class T>
+void BTree<T>::Iterator::descendLeft(const BTreeNode<T> *pNode)
+{
+    while (true) {
+        Position position = { pNode, 0 };
+        m_path.append(position);
+        if (pNode->isLeaf()) {
+            break;
+        }
+        pNode = static_cast<const BTreeInnerNode<T>*>(pNode)->child(0);
+    }
+}
+
+/**
+ * Private
+ * Removes all nodes from the path which have no more keys to visit.
+ */
+template<class T>
+void BTree<T>::Iterator::skipVisited()
+{
+    while (! m_path.isEmpty() && m_path.last().index >= m_path.last().pNode->count()) {
+        m_path.removeLast();
+    }
+}
+
+
+#endif // BTREE_H
@@ -0,0 +1,138 @@
+#ifndef BTREENODE_H
+#define BTREENODE_H
+
+/**
+  * -------------------------------------------------------------------------------------------------------------
+  * Class: BTreeNode<T>
+  * -------------------------------------------------------------------------------------------------------------
+  * Represents one node in a B-tree. A node keeps up to MaxKeys sorted data objects in a contiguous array.
+  * A leave node has no children. An inner node is a BTreeInnerNode<T> with one more child than keys.
+  * This class should not be used. It is handled by the BTree class.
+  *
+  * Node size
+  * ---------
+  * The key array of a node fills NodeLines cache lines. So a search within a node touches only a few
+  * neighbouring cache lines instead of one heap object per key. A node keeps at least 3 keys.
+  * MaxKeys is odd. A full node is split into two nodes with (MaxKeys - 1) / 2 keys and a median key.
+  *
+  * Key storage
+  * -----------
+  * The keys are kept in raw memory which is aligned for T. Only the first count() keys are constructed.
+  * So T needs no default constructor and a new node does not construct MaxKeys objects. The node destroys
+  * its keys.
+  *
+  * Node data
+  * ---------
+  * The node data type must be move constructible and move assignable. It needs the compare operators <, >
+  * and the operator << if equal data is to be united.
+  */
+
+#include <new>
+#include <utility>
+
+
+template<class T>
+class BTreeNode
+{
+public:
+    enum { CacheLineSize = 64, NodeLines = 4 };
+    enum { KeysPerNode = (CacheLineSize * NodeLines) / sizeof(T) < 3 ? 3 : (CacheLineSize * NodeLines) / sizeof(T) };
+    enum { MaxKeys = (KeysPerNode % 2 == 0) ? KeysPerNode - 1 : KeysPerNode };
+
+    explicit BTreeNode(const bool isLeaf = true) :
+        m_count(0),
+        m_isLeaf(isLeaf)
+    {
+
+    }
+
+    ~BTreeNode()
+    {
+        truncate(0);
+    }
+
+    BTreeNode(const BTreeNode&) = delete;
+    BTreeNode& operator = (const BTreeNode&) = delete;
+
+    // Public inline methods
+    int count() const                               { return m_count; }
+    bool isLeaf() const                             { return m_isLeaf; }
+    bool isFull() const                             { return m_count == MaxKeys; }
+    const T& key(const int index) const             { return keys()[index]; }
+    T& key(const int index)                         { return keys()[index]; }
+
+protected:
+    T* keys()                                       { return reinterpret_cast<T*>(m_storage); }
+    const T* keys() const                           { return reinterpret_cast<const T*>(m_storage); }
+    template<class Value>
+    void insertKey(const int position, Value&& data);
+    void truncate(const int count);
+
+protected:
+    int m_count;
+    bool m_isLeaf;
+    alignas(T) unsigned char m_storage[MaxKeys * sizeof(T)];
+
+    template<class> friend class BTree;
+};
+
+
+template<class T>
+class BTreeInnerNode : public BTreeNode<T>
+{
+public:
+    BTreeInnerNode() :
+        BTreeNode<T>(false)
+    {
+        for (int index=0; index<=BTreeNode<T>::MaxKeys; ++index) {
+            m_children[index] = 0;
+        }
+    }
+
+    BTreeNode<T>* child(const int index) const      { return m_children[index]; }
+
+private:
+    BTreeNode<T>* m_children[BTreeNode<T>::MaxKeys + 1];
+
+    template<class> friend class BTree;
+};
+
+
+/**
+ * Inserts a key at a position. The keys behind position are moved one
+ * position up. The node must not be full.
+ * @param position  The index of the new key. At most count().
+ * @param data      The new key. An rvalue is moved.
+ */
+template<class T>
+template<class Value>
+void BTreeNode<T>::insertKey(const int position, Value &&data)
+{
+    T* pKeys = keys();
+    if (position == m_count) {
+        new (pKeys + position) T(std::forward<Value>(data));
+    } else {
+        new (pKeys + m_count) T(std::move(pKeys[m_count - 1]));
+        for (int index=m_count-1; index>position; --index) {
+            pKeys[index] = std::move(pKeys[index - 1]);
+        }
+        pKeys[position] = std::forward<Value>(data);
+    }
+    ++m_count;
+}
+
+/**
+ * Destroys the keys behind count.
+ * @param count     The number of keys to keep.
+ */
+template<class T>
+void BTreeNode<T>::truncate(const int count)
+{
+    T* pKeys = keys();
+    for (int index=count; index<m_count; ++index) {
+        pKeys[index].~T();
+    }
+    m_count = count;
+}
+
+#endif // BTREENODE_H
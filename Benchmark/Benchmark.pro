@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Benchmark of the container templates. Prints
+# the time and rate of each case.
+#
+#-------------------------------------------------
+
+QT       -= gui
+
+TARGET = containerbenchmark
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += .. \
+    ../BinaryTree \
+    ../BTree
+
+SOURCES += main.cpp \
+    containerbenchmark.cpp
+
+HEADERS += containerbenchmark.h
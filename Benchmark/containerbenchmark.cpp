@@ -0,0 +1,286 @@
+#include "containerbenchmark.h"
+#include "binarytree.h"
+#include "btree.h"
+#include "sortlist.h"
+#include "sortedvector.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <random>
+
+
+qint64 BenchmarkPayload::copies = 0;
+
+/**
+ * Inserts a payload object into a container. It is copied or moved.
+ */
+template<class Container, class Value>
+static void insertPayload(Container& container, Value&& payload)
+{
+    container.insert(std::forward<Value>(payload));
+}
+
+/**
+ * A SortedVector collects the payload objects.
+ */
+template<class Value>
+static void insertPayload(SortedVector<BenchmarkPayload>& container, Value&& payload)
+{
+    container.append(std::forward<Value>(payload));
+}
+
+/**
+ * Nothing is left to do in most containers.
+ */
+template<class Container>
+static void finishPayload(Container& container)
+{
+    (void)container;
+}
+
+/**
+ * A SortedVector merges the collected payload objects.
+ */
+static void finishPayload(SortedVector<BenchmarkPayload>& container)
+{
+    container.size();
+}
+
+/**
+ * Constructor
+ * @param count         The number of keys of each case.
+ */
+ContainerBenchmark::ContainerBenchmark(const int count) :
+    m_count(count),
+    m_out(stdout)
+{
+
+}
+
+/**
+ * Runs all cases.
+ */
+void ContainerBenchmark::run()
+{
+    m_out << QString("case").leftJustified(40) << QString("count").rightJustified(10)
+          << QString("ms").rightJustified(10) << QString("per second").rightJustified(14)
+          << QString("copies").rightJustified(10) << endl;
+    benchBinaryTree();
+    benchBTree();
+    benchSortList();
+    benchPayload();
+}
+
+/**
+ * Inserts and finds keys in a BinaryTree in both balance modes.
+ */
+void ContainerBenchmark::benchBinaryTree()
+{
+    typedef BinaryTree<BenchmarkKey> Tree;
+    QVector<int> randomKeys = keys(Random, m_count);
+    KeyOrder orders[] = { Sorted, Reversed, Random };
+    for (int index=0; index<3; ++index) {
+        QVector<int> input = keys(orders[index], m_count);
+        for (int mode=0; mode<2; ++mode) {
+            bool isAvl = mode == 1;
+            if (! isAvl && orders[index] != Random) {
+                // Sorted keys make the unbalanced tree a list.
+                continue;
+            }
+            QString name = QString("binarytree.%1").arg(isAvl ? QString("avl") : QString("unbalanced"));
+            Tree tree;
+            tree.setBalanceMode(isAvl ? Tree::AvlBalanced : Tree::Unbalanced);
+            QElapsedTimer timer;
+            timer.start();
+            for (int key=0; key<input.size(); ++key) {
+                tree.insert(BenchmarkKey(input.at(key)));
+            }
+            addCase(QString("%1.insert.%2").arg(name).arg(orderName(orders[index])), input.size(), timer.nsecsElapsed() / 1000);
+            if (orders[index] != Random) {
+                continue;
+            }
+            timer.restart();
+            int found = 0;
+            for (int key=0; key<randomKeys.size(); ++key) {
+                found += tree.findNodeWith(BenchmarkKey(randomKeys.at(key))) != 0;
+            }
+            addCase(QString("%1.find").arg(name), found, timer.nsecsElapsed() / 1000);
+        }
+    }
+}
+
+/**
+ * Inserts and finds ten times the count of keys in a BTree. The random
+ * keys are also inserted into an AvlBalanced BinaryTree. Both trees are
+ * not alive at the same time.
+ */
+void ContainerBenchmark::benchBTree()
+{
+    int count = m_count * 10;
+    QVector<int> randomKeys = keys(Random, count);
+    {
+        QVector<int> sortedKeys = keys(Sorted, count);
+        BTree<BenchmarkKey> tree;
+        QElapsedTimer timer;
+        timer.start();
+        for (int index=0; index<sortedKeys.size(); ++index) {
+            tree.insert(BenchmarkKey(sortedKeys.at(index)));
+        }
+        addCase(QString("btree.insert.sorted"), count, timer.nsecsElapsed() / 1000);
+    }
+    {
+        BTree<BenchmarkKey> tree;
+        QElapsedTimer timer;
+        timer.start();
+        for (int index=0; index<randomKeys.size(); ++index) {
+            tree.insert(BenchmarkKey(randomKeys.at(index)));
+        }
+        addCase(QString("btree.insert.random"), count, timer.nsecsElapsed() / 1000);
+        timer.restart();
+        int found = 0;
+        for (int index=randomKeys.size()-1; index>=0; --index) {
+            found += tree.find(BenchmarkKey(randomKeys.at(index))) != 0;
+        }
+        addCase(QString("btree.find"), found, timer.nsecsElapsed() / 1000);
+    }
+    {
+        BinaryTree<BenchmarkKey> tree;
+        tree.setBalanceMode(BinaryTree<BenchmarkKey>::AvlBalanced);
+        QElapsedTimer timer;
+        timer.start();
+        for (int index=0; index<randomKeys.size(); ++index) {
+            tree.insert(BenchmarkKey(randomKeys.at(index)));
+        }
+        addCase(QString("btree.binarytree.avl.insert.random"), count, timer.nsecsElapsed() / 1000);
+        timer.restart();
+        int found = 0;
+        for (int index=randomKeys.size()-1; index>=0; --index) {
+            found += tree.findNodeWith(BenchmarkKey(randomKeys.at(index))) != 0;
+        }
+        addCase(QString("btree.binarytree.avl.find"), found, timer.nsecsElapsed() / 1000);
+    }
+}
+
+/**
+ * Inserts keys in each order into a SortList.
+ */
+void ContainerBenchmark::benchSortList()
+{
+    KeyOrder orders[] = { Sorted, Reversed, Random };
+    for (int index=0; index<3; ++index) {
+        QVector<int> input = keys(orders[index], m_count);
+        SortList<BenchmarkKey> list;
+        QElapsedTimer timer;
+        timer.start();
+        for (int key=0; key<input.size(); ++key) {
+            list.insert(BenchmarkKey(input.at(key)));
+        }
+        addCase(QString("sortlist.insert.%1").arg(orderName(orders[index])), list.size(), timer.nsecsElapsed() / 1000);
+    }
+}
+
+/**
+ * Inserts payload objects into each container. Once they are copied in
+ * and once they are moved in.
+ */
+void ContainerBenchmark::benchPayload()
+{
+    QVector<int> input = keys(Random, m_count);
+    addPayloadCases<SortList<BenchmarkPayload> >(QString("sortlist"), input);
+    addPayloadCases<BinaryTree<BenchmarkPayload> >(QString("binarytree.unbalanced"), input);
+    addPayloadCases<BTree<BenchmarkPayload> >(QString("btree"), input);
+    addPayloadCases<SortedVector<BenchmarkPayload> >(QString("sortedvector"), input);
+}
+
+/**
+ * Private
+ * Inserts the payload objects of the keys into a new container with
+ * insert(const T&) and into another one with insert(T&&). The objects
+ * are created before the timer starts. A SortedVector collects the
+ * objects with append() and merges them on size().
+ * @param name          The name of the container for the case names.
+ * @param input         The keys of the payload objects.
+ */
+template<class Container>
+void ContainerBenchmark::addPayloadCases(const QString &name, const QVector<int> &input)
+{
+    for (int mode=0; mode<2; ++mode) {
+        bool isMove = mode == 1;
+        std::vector<BenchmarkPayload> payloads(input.begin(), input.end());
+        Container container;
+        BenchmarkPayload::copies = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (size_t index=0; index<payloads.size(); ++index) {
+            if (isMove) {
+                insertPayload(container, std::move(payloads[index]));
+            } else {
+                insertPayload(container, payloads[index]);
+            }
+        }
+        finishPayload(container);
+        addCase(QString("%1.payload.%2").arg(name).arg(isMove ? QString("move") : QString("copy")),
+                payloads.size(), timer.nsecsElapsed() / 1000, BenchmarkPayload::copies);
+    }
+}
+
+/**
+ * Private
+ * Creates the keys 0 to count - 1 in the given order. Random order uses
+ * a fixed seed.
+ * @param order         The order of keys.
+ * @param count         The number of keys.
+ * @return              The keys.
+ */
+QVector<int> ContainerBenchmark::keys(const KeyOrder order, const int count) const
+{
+    QVector<int> keys(count);
+    for (int index=0; index<count; ++index) {
+        keys[index] = (order == Reversed) ? count - 1 - index : index;
+    }
+    if (order == Random) {
+        std::mt19937 generator(42);
+        std::shuffle(keys.begin(), keys.end(), generator);
+    }
+
+    return keys;
+}
+
+/**
+ * Private
+ * The name of a key order for case names.
+ * @param order         The order of keys.
+ * @return              The name.
+ */
+QString ContainerBenchmark::orderName(const KeyOrder order)
+{
+    switch (order) {
+    case Sorted:
+        return QString("sorted");
+    case Reversed:
+        return QString("reversed");
+    case Random:
+        break;
+    }
+
+    return QString("random");
+}
+
+/**
+ * Private
+ * Prints a case.
+ * @param name          The name of the case.
+ * @param count         The number of operations.
+ * @param microseconds  The time of all operations.
+ * @param copies        The number of copied payload objects or -1.
+ */
+void ContainerBenchmark::addCase(const QString &name, const qint64 count, const qint64 microseconds, const qint64 copies)
+{
+    double perSecond = microseconds > 0 ? count * 1000000.0 / microseconds : 0.0;
+    m_out << name.leftJustified(40) << QString::number(count).rightJustified(10)
+          << QString::number(microseconds / 1000.0, 'f', 1).rightJustified(10)
+          << QString::number(perSecond, 'f', 0).rightJustified(14);
+    if (copies >= 0) {
+        m_out << QString::number(copies).rightJustified(10);
+    }
+    m_out << endl;
+}
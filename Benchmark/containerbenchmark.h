@@ -0,0 +1,141 @@
+#ifndef CONTAINERBENCHMARK_H
+#define CONTAINERBENCHMARK_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          ContainerBenchmark
+ * -------------------------------------------------------------------------------------
+ * Benchmark cases for the container templates. The keys are sorted, reversed
+ * or shuffled with a fixed seed. So two runs use the same input.
+ *
+ * binarytree.<mode>.insert.<order>     Insert keys one by one.
+ * binarytree.<mode>.find               Find each key in random order.
+ * btree.insert.<order>                 Insert ten times as many keys into a BTree.
+ * btree.find                           Find each of these keys in random order.
+ * btree.binarytree.avl.<operation>     The same random keys with an AvlBalanced
+ *                                      BinaryTree for comparison.
+ * sortlist.insert.<order>              Insert keys one by one into a SortList.
+ * <container>.payload.<copy|move>      Insert random payload objects with
+ *                                      insert(const T&) or insert(T&&). The
+ *                                      copies of payload objects are counted.
+ *
+ * mode is 'unbalanced' or 'avl'. The unbalanced tree gets random keys only.
+ * Sorted keys make it a list with O(n) per insert. The BTree cases use
+ * 10,000,000 keys with the default count.
+ * Each case prints its count, the time in milliseconds and the rate per second.
+ * The payload cases also print the number of copies.
+ */
+
+#include <QString>
+#include <QVector>
+#include <QTextStream>
+#include <vector>
+#include <utility>
+
+
+class ContainerBenchmark
+{
+public:
+    enum KeyOrder { Sorted, Reversed, Random };
+
+    explicit ContainerBenchmark(const int count);
+
+    void run();
+
+private:
+    void benchBinaryTree();
+    void benchBTree();
+    void benchSortList();
+    void benchPayload();
+    template<class Container>
+    void addPayloadCases(const QString& name, const QVector<int>& input);
+    QVector<int> keys(const KeyOrder order, const int count) const;
+    static QString orderName(const KeyOrder order);
+    void addCase(const QString& name, const qint64 count, const qint64 microseconds, const qint64 copies = -1);
+
+private:
+    int m_count;
+    QTextStream m_out;
+};
+
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          BenchmarkKey
+ * -------------------------------------------------------------------------------------
+ * User data of the benchmark. A key with the operators which the containers need.
+ */
+class BenchmarkKey
+{
+public:
+    BenchmarkKey(const int key = 0) :
+        m_key(key)
+    {
+
+    }
+
+    int key() const                                         { return m_key; }
+    QString toString() const                                { return QString::number(m_key); }
+
+    bool operator < (const BenchmarkKey& rhs) const         { return m_key < rhs.m_key; }
+    bool operator > (const BenchmarkKey& rhs) const         { return m_key > rhs.m_key; }
+    bool operator == (const BenchmarkKey& rhs) const        { return m_key == rhs.m_key; }
+    void operator << (const BenchmarkKey& rhs)              { (void)rhs; }
+
+private:
+    int m_key;
+};
+
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          BenchmarkPayload
+ * -------------------------------------------------------------------------------------
+ * A large user data object. Beside the key it has a buffer in the heap memory. So
+ * a copy allocates memory while a move only takes the buffer. Each copy is counted.
+ */
+class BenchmarkPayload
+{
+public:
+    enum { PayloadSize = 32 };
+
+    BenchmarkPayload(const int key = 0) :
+        m_key(key),
+        m_payload(PayloadSize, key)
+    {
+
+    }
+
+    BenchmarkPayload(const BenchmarkPayload& other) :
+        m_key(other.m_key),
+        m_payload(other.m_payload)
+    {
+        ++copies;
+    }
+
+    BenchmarkPayload(BenchmarkPayload&& other) noexcept :
+        m_key(other.m_key),
+        m_payload(std::move(other.m_payload))
+    {
+
+    }
+
+    BenchmarkPayload& operator = (const BenchmarkPayload& other)    { m_key = other.m_key; m_payload = other.m_payload; ++copies; return *this; }
+    BenchmarkPayload& operator = (BenchmarkPayload&& other) noexcept { m_key = other.m_key; m_payload = std::move(other.m_payload); return *this; }
+
+    int key() const                                             { return m_key; }
+    QString toString() const                                    { return QString::number(m_key); }
+
+    bool operator < (const BenchmarkPayload& rhs) const         { return m_key < rhs.m_key; }
+    bool operator > (const BenchmarkPayload& rhs) const         { return m_key > rhs.m_key; }
+    bool operator == (const BenchmarkPayload& rhs) const        { return m_key == rhs.m_key; }
+    void operator << (const BenchmarkPayload& rhs)              { (void)rhs; }
+
+    static qint64 copies;
+
+private:
+    int m_key;
+    std::vector<int> m_payload;
+};
+
+#endif // CONTAINERBENCHMARK_H
@@ -0,0 +1,22 @@
+#include "containerbenchmark.h"
+#include <QCoreApplication>
+
+
+/**
+ * Runs all container benchmarks and prints a line for each case.
+ *      containerbenchmark [count]
+ * count is the number of keys of the large cases.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    int count = 1000000;
+    if (arguments.size() > 1) {
+        count = qMax(1000, arguments.at(1).toInt());
+    }
+    ContainerBenchmark benchmark(count);
+    benchmark.run();
+
+    return 0;
+}
@@ -27,6 +27,34 @@
   * EqualBehaviour::Lesser
   *     The new node is equal but is taken as a lesser node.
   *
+  * BalanceMode
+  * ------------
+  * By default the tree is not balanced. Sorted input makes it a list.
+  *
+  * BalanceMode::Unbalanced
+  *     Nodes are added as leaves. The shape of the tree depends on the order of input.
+  * BalanceMode::AvlBalanced
+  *     The tree is rebalanced with rotations after each insert (AVL tree). The heights
+  *     of left and rigth subtree differ at most by one. Insert and find are O(log n).
+  *     The mode should be set before the first insert.
+  *
+  * Rotations keep the order of nodes. Equal nodes keep their order with EqualToLesser
+  * and EqualToGreater.
+  *
+  * Allocator
+  * ----------
+  * The tree nodes are allocated by the Allocator policy (see nodeallocator.h). With the PoolNodeAllocator
+  * nodes are taken from large slabs and the destructor releases all nodes at once. Nodes are only visited
+  * on destruction if T has a destructor. A node given to insert(TreeNode<T>*) must be created with
+  * createNode() or emplaceNode(). With the default HeapNodeAllocator a node from 'new TreeNode<T>(data)'
+  * can be inserted as before.
+  *
+  * Traversal
+  * ----------
+  * begin() and end() give STL-style iterators which visit the user data in ascending order. So the tree
+  * can be used in a range-for loop. Pre-order and post-order iterators are available too. Iterators,
+  * destruction and toString() work without recursion.
+  *
   * Tree String
   * ------------
   * It is required to implement a 'toString()' method in the user data object. It should return a QString
@@ -38,15 +66,38 @@
   * operator overloads (<, ==, >, <<) in the user data object T.
   * Additional it is required to implement a 'toString()' method in the user data object.
   *
-  * ToDo:
-  * - remove function
+  * Bulk build
+  * -----------
+  * buildFromSorted() replaces the content of the tree with objects from a sorted range. It builds a perfectly
+  * balanced tree in O(n) without any comparison of nodes on the way down. Equal objects are united with
+  * KeepEqual. With EqualToLesser equal objects are in reverse input order, like after single inserts.
+  * With the PoolNodeAllocator all nodes are taken from one contiguous slab.
+  *
+  * Move semantics
+  * ---------------
+  * insert(T&&) moves the user data into the new node. emplace() constructs the user data in the new node
+  * from its arguments. TreeNode::userData() and the iterators return references. So large user data objects
+  * are not copied.
+  *
+  * Range queries
+  * --------------
+  * lowerBound() and upperBound() return in-order iterators like the STL functions. forEachInRange()
+  * visits only the nodes within a closed range. With AvlBalanced this is O(log n + k) for k nodes.
+  * erase() removes all nodes which are equal to a key and rebalances the tree.
   */
 
 #include <treenode.h>
+#include <treeiterator.h>
+#include <nodeallocator.h>
+#include <QVarLengthArray>
 #include <QDebug>
+#include <type_traits>
+#include <iterator>
+#include <algorithm>
+#include <utility>
 
 
-template<class T>
+template<class T, template<class> class Allocator = HeapNodeAllocator>
 class BinaryTree
 {
     friend class TreeNode<T>;
@@ -55,11 +106,17 @@ public:
 
     enum EqualBehaviour { EqualToLesser = -1, KeepEqual = 0, EqualToGreater = 1 };
     enum CompareResult { Lesser = -1, Equal = 0, Greater = 1 };
+    enum BalanceMode { Unbalanced, AvlBalanced };
+    typedef TreeIterator<T, InOrder> iterator;
+    typedef TreeIterator<T, InOrder> const_iterator;
+    typedef TreeIterator<T, PreOrder> PreOrderIterator;
+    typedef TreeIterator<T, PostOrder> PostOrderIterator;
 
     // Constructor
     BinaryTree() :
         m_pRoot(0),
-        m_equalBehaviour(EqualToLesser)
+        m_equalBehaviour(EqualToLesser),
+        m_balanceMode(Unbalanced)
     {
 
     }
@@ -67,24 +124,70 @@ public:
     // Destructor
     ~BinaryTree()
     {
-        removeDescendantsFrom(m_pRoot);
-        delete m_pRoot;
+        clear();
     }
 
     // Public member functions.
     void insert(const T& data);
+    void insert(T&& data)                                       { insert(createNode(std::move(data))); }
+    template<class... Args>
+    void emplace(Args&&... args)                                { insert(emplaceNode(std::forward<Args>(args)...)); }
     void insert(TreeNode<T> * const pNewNode);
+    TreeNode<T>* createNode(const T& data);
+    TreeNode<T>* createNode(T&& data);
+    template<class... Args>
+    TreeNode<T>* emplaceNode(Args&&... args);
+    void clear();
+    template<class Iterator>
+    void buildFromSorted(Iterator first, Iterator last);
     QString toString() const;
     void setEqualBehaviour(const EqualBehaviour behaviour)      { m_equalBehaviour = behaviour; }
     EqualBehaviour equalBehaviour() const                       { return m_equalBehaviour; }
+    void setBalanceMode(const BalanceMode mode)                 { m_balanceMode = mode; }
+    BalanceMode balanceMode() const                             { return m_balanceMode; }
+    int height() const                                          { return heightOf(m_pRoot); }
     TreeNode<T>* findNodeWith(const T& data) const;
     void removeDescendantsFrom(TreeNode<T> *pNode);
+    int erase(const T& data);
+
+    // Range queries
+    iterator lowerBound(const T& data) const;
+    iterator upperBound(const T& data) const;
+    template<class Function>
+    void forEachInRange(const T& lower, const T& upper, Function function) const;
+
+    // Traversal. begin() and end() iterate in order and allow range-for.
+    iterator begin() const                                      { return iterator(m_pRoot); }
+    iterator end() const                                        { return iterator(); }
+    PreOrderIterator preOrderBegin() const                      { return PreOrderIterator(m_pRoot); }
+    PreOrderIterator preOrderEnd() const                        { return PreOrderIterator(); }
+    PostOrderIterator postOrderBegin() const                    { return PostOrderIterator(m_pRoot); }
+    PostOrderIterator postOrderEnd() const                      { return PostOrderIterator(); }
 
 private:
     TreeNode<T>* m_pRoot;
     EqualBehaviour m_equalBehaviour;
+    BalanceMode m_balanceMode;
+    Allocator<TreeNode<T> > m_allocator;
+
+    // A path from root down to a node.
+    typedef QVarLengthArray<TreeNode<T>*, 64> NodePath;
+    // Nodes in order.
+    typedef QVarLengthArray<TreeNode<T>*, 256> NodeList;
 
     // Private member functions.
+    static int heightOf(const TreeNode<T>* const pNode)         { return pNode ? pNode->height() : 0; }
+    static void updateHeight(TreeNode<T>* const pNode);
+    static TreeNode<T>* rotateLeft(TreeNode<T>* const pNode);
+    static TreeNode<T>* rotateRight(TreeNode<T>* const pNode);
+    TreeNode<T>* balance(TreeNode<T>* const pNode) const;
+    void rebalancePath(const NodePath& path);
+    bool findPath(const TreeNode<T>* const pTarget, NodePath& path) const;
+    void linkBalanced(const NodeList& nodes);
+    void rebuildBalanced();
+    void replaceChild(TreeNode<T>* pParent, TreeNode<T>* pChild, TreeNode<T>* pNewChild);
+    bool eraseNode(const T& data);
+    void destroyNode(TreeNode<T>* pNode);
     void appendNodeString(TreeNode<T> *pNode, QString& treeString, const int space) const;
     CompareResult compareNodes(const TreeNode<T>* const pNode, const TreeNode<T>* const pCompareNode) const;
     CompareResult compareNodesWithData(const TreeNode<T>* const pNode, const T& data) const;
@@ -101,27 +204,30 @@ private:
  * added as rigth child.
  * Therefore the data T object must overload operators '<', '>', '=='.
  */
-template<typename T>
-void BinaryTree<T>::insert(const T& data)
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::insert(const T& data)
 {
-    TreeNode<T>* pNewNode = new TreeNode<T>(data);
-    insert(pNewNode);
+    insert(createNode(data));
 }
 
 /**
- * @brief BinaryTree::insert
- * @param pNewNode
+ * Adds a node to the tree. The path from root to the new leave is
+ * kept. Afterwards the heights of all nodes on the path are updated.
+ * If the tree is AvlBalanced the nodes on the path are rebalanced.
+ * @param pNewNode      The new node from createNode(). The tree takes ownership.
  */
-template<class T>
-void BinaryTree<T>::insert(TreeNode<T> * const pNewNode)
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::insert(TreeNode<T> * const pNewNode)
 {
     if (m_pRoot == 0) {
         m_pRoot = pNewNode;
         return;
     }
+    NodePath path;
     TreeNode<T>* pCurrentNode = m_pRoot;
     bool notInserted = true;
     while (notInserted) {
+        path.append(pCurrentNode);
         CompareResult result = compareNodes(pCurrentNode, pNewNode);
         if (result == Equal) {
             // Changes result to 'Equal' behaviour.
@@ -138,10 +244,10 @@ void BinaryTree<T>::insert(TreeNode<T> * const pNewNode)
             }
             break;
         case Equal:
+            // Nodes are united. The shape of the tree is not changed.
             *pCurrentNode << pNewNode;
-            delete pNewNode;
-            notInserted = false;
-            break;
+            destroyNode(pNewNode);
+            return;
         case Greater:
             if (pCurrentNode->hasRigthChild()) {
                 pCurrentNode = pCurrentNode->rigthChild();
@@ -152,6 +258,102 @@ void BinaryTree<T>::insert(TreeNode<T> * const pNewNode)
             break;
         }
     }
+    rebalancePath(path);
+}
+
+/**
+ * Creates a node in memory of the allocator. The node can be given to
+ * insert(). It is owned by the tree afterwards.
+ * @param data      The user data of the node.
+ * @return          The new node.
+ */
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::createNode(const T &data)
+{
+    return new (m_allocator.allocate()) TreeNode<T>(data);
+}
+
+/**
+ * Creates a node in memory of the allocator and moves data into it.
+ * @param data      The user data of the node. It is moved.
+ * @return          The new node.
+ */
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::createNode(T &&data)
+{
+    return new (m_allocator.allocate()) TreeNode<T>(std::move(data));
+}
+
+/**
+ * Creates a node in memory of the allocator. The user data is constructed
+ * in the node from the arguments.
+ * @param args      The arguments of a constructor of T.
+ * @return          The new node.
+ */
+template<class T, template<class> class Allocator>
+template<class... Args>
+TreeNode<T> *BinaryTree<T, Allocator>::emplaceNode(Args&&... args)
+{
+    return new (m_allocator.allocate()) TreeNode<T>(typename TreeNode<T>::InPlace(), std::forward<Args>(args)...);
+}
+
+/**
+ * Deletes all nodes of the tree. If the allocator can release all
+ * nodes at once and T has no destructor the nodes are not visited.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::clear()
+{
+    if (m_pRoot == 0) {
+        return;
+    }
+    if (! Allocator<TreeNode<T> >::CanReset || ! std::is_trivially_destructible<T>::value) {
+        removeDescendantsFrom(m_pRoot);
+        destroyNode(m_pRoot);
+    }
+    m_allocator.reset();
+    m_pRoot = 0;
+}
+
+/**
+ * Replaces the content of the tree with the objects of a sorted range.
+ * Nodes are created in order. Then the middle node of each part becomes
+ * the root of this part. The tree is perfectly balanced afterwards.
+ * The range must be sorted ascending. It is read twice.
+ * @param first     An iterator to the first object.
+ * @param last      An iterator behind the last object.
+ */
+template<class T, template<class> class Allocator>
+template<class Iterator>
+void BinaryTree<T, Allocator>::buildFromSorted(Iterator first, Iterator last)
+{
+    clear();
+    int count = std::distance(first, last);
+    if (count == 0) {
+        return;
+    }
+    m_allocator.reserve(count);
+    NodeList nodes;
+    nodes.reserve(count);
+    int runStart = 0;
+    for (; first != last; ++first) {
+        if (! nodes.isEmpty() && compareNodesWithData(nodes.last(), *first) == Equal) {
+            if (m_equalBehaviour == KeepEqual) {
+                *nodes.last()->ptrUserData() << *first;
+                continue;
+            }
+        } else {
+            if (m_equalBehaviour == EqualToLesser) {
+                std::reverse(nodes.begin() + runStart, nodes.end());
+            }
+            runStart = nodes.size();
+        }
+        nodes.append(createNode(*first));
+    }
+    if (m_equalBehaviour == EqualToLesser) {
+        std::reverse(nodes.begin() + runStart, nodes.end());
+    }
+    linkBalanced(nodes);
 }
 
 /**
@@ -162,8 +364,8 @@ void BinaryTree<T>::insert(TreeNode<T> * const pNewNode)
  * To get a real representation the data T object must implement the 'toString()'
  * method.
  */
-template<class T>
-QString BinaryTree<T>::toString() const
+template<class T, template<class> class Allocator>
+QString BinaryTree<T, Allocator>::toString() const
 {
     if (m_pRoot == 0) {
         return QString("Is empty.");
@@ -179,8 +381,8 @@ QString BinaryTree<T>::toString() const
  * @param data      A user data object with content to search for in the tree.
  * @return pNode    Returns a tree node object pointer or NULL.
  */
-template<class T>
-TreeNode<T> *BinaryTree<T>::findNodeWith(const T &data) const
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::findNodeWith(const T &data) const
 {
     TreeNode<T>* pNode = m_pRoot;
     while (pNode) {
@@ -202,23 +404,117 @@ TreeNode<T> *BinaryTree<T>::findNodeWith(const T &data) const
 }
 
 /**
- * Walk recursively through the tree and build a string representation.
- * @param pNode         The next node.
- * @param treeString    A string reference to append node strings.
- * @param space         A space value depending on the current deepth.
+ * Removes all nodes with user data equal to data from the tree.
+ * The tree is rebalanced if it is AvlBalanced.
+ * @param data      A user data object with the content to remove.
+ * @return          The number of removed nodes.
+ */
+template<class T, template<class> class Allocator>
+int BinaryTree<T, Allocator>::erase(const T &data)
+{
+    int count = 0;
+    while (eraseNode(data)) {
+        ++count;
+    }
+
+    return count;
+}
+
+/**
+ * Find the first node in order which is not lesser than data.
+ * @param data      A user data object to compare with.
+ * @return          An in-order iterator to the node or end().
+ */
+template<class T, template<class> class Allocator>
+typename BinaryTree<T, Allocator>::iterator BinaryTree<T, Allocator>::lowerBound(const T &data) const
+{
+    iterator position;
+    TreeNode<T>* pNode = m_pRoot;
+    while (pNode) {
+        if (compareNodesWithData(pNode, data) == Greater) {
+            pNode = pNode->rigthChild();
+        } else {
+            // Node is a candidate. Nodes left of it come first in order.
+            position.m_stack.append(pNode);
+            pNode = pNode->leftChild();
+        }
+    }
+
+    return position;
+}
+
+/**
+ * Find the first node in order which is greater than data.
+ * @param data      A user data object to compare with.
+ * @return          An in-order iterator to the node or end().
  */
-template<class T>
-void BinaryTree<T>::appendNodeString(TreeNode<T>* pNode, QString &treeString, const int space) const
+template<class T, template<class> class Allocator>
+typename BinaryTree<T, Allocator>::iterator BinaryTree<T, Allocator>::upperBound(const T &data) const
 {
-    if (pNode->hasRigthChild()) {
-        appendNodeString(pNode->rigthChild(), treeString, space + 5);
+    iterator position;
+    TreeNode<T>* pNode = m_pRoot;
+    while (pNode) {
+        if (compareNodesWithData(pNode, data) == Lesser) {
+            position.m_stack.append(pNode);
+            pNode = pNode->leftChild();
+        } else {
+            pNode = pNode->rigthChild();
+        }
     }
 
-    QString spaceString(space, ' ');
-    treeString.append(spaceString).append(pNode->toString());
+    return position;
+}
+
+/**
+ * Calls a function for each user data object within a closed range in
+ * ascending order. Only the nodes within the range are visited.
+ * @param lower     The least user data object of the range.
+ * @param upper     The greatest user data object of the range.
+ * @param function  A function or functor which takes a 'const T&'.
+ */
+template<class T, template<class> class Allocator>
+template<class Function>
+void BinaryTree<T, Allocator>::forEachInRange(const T &lower, const T &upper, Function function) const
+{
+    iterator last = end();
+    for (iterator position = lowerBound(lower); position != last; ++position) {
+        if (compareNodesWithData(position.node(), upper) == Lesser) {
+            break;
+        }
+        function(*position);
+    }
+}
 
-    if (pNode->hasLeftChild()) {
-        appendNodeString(pNode->leftChild(), treeString, space + 5);
+/**
+ * Walk through the tree and build a string representation. Nodes are
+ * visited from rigth to left. The path is kept in a stack. So a deep
+ * tree does not need a deep call stack.
+ * @param pNode         The root node of the (sub)tree.
+ * @param treeString    A string reference to append node strings.
+ * @param space         A space value depending on the current deepth.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::appendNodeString(TreeNode<T>* pNode, QString &treeString, const int space) const
+{
+    struct Entry {
+        TreeNode<T>* pNode;
+        int space;
+    };
+    QVarLengthArray<Entry, 64> stack;
+    int nodeSpace = space;
+    while (pNode || ! stack.isEmpty()) {
+        while (pNode) {
+            Entry entry = { pNode, nodeSpace };
+            stack.append(entry);
+            pNode = pNode->rigthChild();
+            nodeSpace += 5;
+        }
+        Entry entry = stack.last();
+        stack.removeLast();
+        QString spaceString(entry.space, ' ');
+        treeString.append(spaceString).append(entry.pNode->toString());
+        pNode = entry.pNode->leftChild();
+        nodeSpace = entry.space + 5;
     }
 }
 
@@ -229,8 +525,8 @@ void BinaryTree<T>::appendNodeString(TreeNode<T>* pNode, QString &treeString, co
  * @return              Return Lesser (-1) if pCompareNode data is lesser then data of pNode.
  *                      Return Greater (1) if pCompareNode data is greater. Otherwise Equal (0).
  */
-template<class T>
-typename BinaryTree<T>::CompareResult BinaryTree<T>::compareNodes(const TreeNode<T> * const pNode, const TreeNode<T> * const pCompareNode) const
+template<class T, template<class> class Allocator>
+typename BinaryTree<T, Allocator>::CompareResult BinaryTree<T, Allocator>::compareNodes(const TreeNode<T> * const pNode, const TreeNode<T> * const pCompareNode) const
 {
     return compareNodesWithData(pNode, pCompareNode->userData());
 }
@@ -243,8 +539,8 @@ typename BinaryTree<T>::CompareResult BinaryTree<T>::compareNodes(const TreeNode
  *                      Return Greater (1) if data is greater then node data.
  *                      Return Equal (0) if node data and data are equal.
  */
-template<class T>
-typename BinaryTree<T>::CompareResult BinaryTree<T>::compareNodesWithData(const TreeNode<T> * const pNode, const T &data) const
+template<class T, template<class> class Allocator>
+typename BinaryTree<T, Allocator>::CompareResult BinaryTree<T, Allocator>::compareNodesWithData(const TreeNode<T> * const pNode, const T &data) const
 {
     const T& nodeData = pNode->userData();
     if (data < nodeData) {
@@ -258,24 +554,350 @@ typename BinaryTree<T>::CompareResult BinaryTree<T>::compareNodesWithData(const
 }
 
 /**
- * Delete the tree or a part of the tree from memory.
- * @param pNode     From this node all childes will be deleted.
+ * Sets the height of a node from the heights of its children.
+ * @param pNode     The node to update.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::updateHeight(TreeNode<T> * const pNode)
+{
+    pNode->setHeight(qMax(heightOf(pNode->leftChild()), heightOf(pNode->rigthChild())) + 1);
+}
+
+/**
+ * Rotates a subtree to the left. The rigth child becomes the new
+ * root of the subtree.
+ * @param pNode     The root of the subtree. Must have a rigth child.
+ * @return          The new root of the subtree.
  */
-template<class T>
-void BinaryTree<T>::removeDescendantsFrom(TreeNode<T>* pNode)
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::rotateLeft(TreeNode<T> * const pNode)
 {
-    if (pNode->hasLeftChild()) {
+    TreeNode<T>* pRigthNode = pNode->rigthChild();
+    pNode->setRigthChild(pRigthNode->leftChild());
+    pRigthNode->setLeftChild(pNode);
+    updateHeight(pNode);
+    updateHeight(pRigthNode);
+
+    return pRigthNode;
+}
+
+/**
+ * Rotates a subtree to the rigth. The left child becomes the new
+ * root of the subtree.
+ * @param pNode     The root of the subtree. Must have a left child.
+ * @return          The new root of the subtree.
+ */
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::rotateRight(TreeNode<T> * const pNode)
+{
+    TreeNode<T>* pLeftNode = pNode->leftChild();
+    pNode->setLeftChild(pLeftNode->rigthChild());
+    pLeftNode->setRigthChild(pNode);
+    updateHeight(pNode);
+    updateHeight(pLeftNode);
+
+    return pLeftNode;
+}
+
+/**
+ * Updates the height of a node. If the tree is AvlBalanced and the
+ * heights of the subtrees differ by more than one the subtree is
+ * rotated.
+ * @param pNode     The root of the subtree.
+ * @return          The root of the subtree after balancing.
+ */
+template<class T, template<class> class Allocator>
+TreeNode<T> *BinaryTree<T, Allocator>::balance(TreeNode<T> * const pNode) const
+{
+    updateHeight(pNode);
+    if (m_balanceMode == Unbalanced) {
+        return pNode;
+    }
+    int factor = heightOf(pNode->leftChild()) - heightOf(pNode->rigthChild());
+    if (factor > 1) {
         TreeNode<T>* pLeftNode = pNode->leftChild();
-        removeDescendantsFrom(pLeftNode);
-        delete pLeftNode;
-        pNode->setLeftChild(NULL);
+        if (heightOf(pLeftNode->leftChild()) < heightOf(pLeftNode->rigthChild())) {
+            pNode->setLeftChild(rotateLeft(pLeftNode));
+        }
+        return rotateRight(pNode);
     }
-    if (pNode->hasRigthChild()) {
+    if (factor < -1) {
         TreeNode<T>* pRigthNode = pNode->rigthChild();
-        removeDescendantsFrom(pRigthNode);
-        delete pRigthNode;
-        pNode->setRigthChild(NULL);
+        if (heightOf(pRigthNode->rigthChild()) < heightOf(pRigthNode->leftChild())) {
+            pNode->setRigthChild(rotateRight(pRigthNode));
+        }
+        return rotateLeft(pNode);
     }
+
+    return pNode;
+}
+
+/**
+ * Balances all nodes on a path from the lowest node up to the root.
+ * A rotated subtree is linked to its parent. Stops if the height of a
+ * subtree did not change. Nodes above are not affected then.
+ * @param path      The path from root down to a changed node.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::rebalancePath(const NodePath &path)
+{
+    for (int index=path.size()-1; index>=0; --index) {
+        TreeNode<T>* pNode = path.at(index);
+        int height = pNode->height();
+        TreeNode<T>* pSubtree = balance(pNode);
+        if (pSubtree != pNode) {
+            replaceChild(index > 0 ? path.at(index - 1) : 0, pNode, pSubtree);
+        }
+        if (pSubtree->height() == height) {
+            break;
+        }
+    }
+}
+
+/**
+ * Private
+ * Replaces a child of a node with another node or subtree.
+ * @param pParent       The parent node. If NULL the root is replaced.
+ * @param pChild        The current child of pParent.
+ * @param pNewChild     The new child. Can be NULL.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::replaceChild(TreeNode<T> *pParent, TreeNode<T> *pChild, TreeNode<T> *pNewChild)
+{
+    if (pParent == 0) {
+        m_pRoot = pNewChild;
+    } else if (pParent->leftChild() == pChild) {
+        pParent->setLeftChild(pNewChild);
+    } else {
+        pParent->setRigthChild(pNewChild);
+    }
+}
+
+/**
+ * Private
+ * Removes one node with user data equal to data. A node with two
+ * children is replaced by the least node of its rigth subtree. The
+ * nodes are relinked. So pointers to other nodes stay valid.
+ * Afterwards the path up to the root is rebalanced.
+ * @param data      A user data object with the content to remove.
+ * @return          True if a node was removed.
+ */
+template<class T, template<class> class Allocator>
+bool BinaryTree<T, Allocator>::eraseNode(const T &data)
+{
+    NodePath path;
+    TreeNode<T>* pNode = m_pRoot;
+    while (pNode) {
+        CompareResult result = compareNodesWithData(pNode, data);
+        if (result == Equal) {
+            break;
+        }
+        path.append(pNode);
+        pNode = (result == Lesser) ? pNode->leftChild() : pNode->rigthChild();
+    }
+    if (pNode == 0) {
+        return false;
+    }
+    TreeNode<T>* pParent = path.isEmpty() ? 0 : path.last();
+    if (pNode->hasLeftChild() && pNode->hasRigthChild()) {
+        // Take the successor out of the rigth subtree and put it in place of the node.
+        int nodeIndex = path.size();
+        path.append(pNode);
+        TreeNode<T>* pSuccessor = pNode->rigthChild();
+        while (pSuccessor->hasLeftChild()) {
+            path.append(pSuccessor);
+            pSuccessor = pSuccessor->leftChild();
+        }
+        replaceChild(path.last(), pSuccessor, pSuccessor->rigthChild());
+        pSuccessor->setLeftChild(pNode->leftChild());
+        pSuccessor->setRigthChild(pNode->rigthChild());
+        pSuccessor->setHeight(pNode->height());
+        replaceChild(pParent, pNode, pSuccessor);
+        path[nodeIndex] = pSuccessor;
+    } else {
+        replaceChild(pParent, pNode, pNode->hasLeftChild() ? pNode->leftChild() : pNode->rigthChild());
+    }
+    destroyNode(pNode);
+    rebalancePath(path);
+
+    return true;
+}
+
+/**
+ * Delete the tree or a part of the tree from memory.
+ * Works without recursion and without a stack. A node with a left child
+ * is rotated to the rigth until the left child is gone. Then the node is
+ * deleted and its rigth child is next.
+ * If pNode is a node of this tree the heights of its ancestors are
+ * updated. An AvlBalanced tree which is unbalanced afterwards is
+ * rebuilt in O(n).
+ * @param pNode     From this node all childes will be deleted.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::removeDescendantsFrom(TreeNode<T>* pNode)
+{
+    NodePath path;
+    bool isInTree = pNode != m_pRoot && findPath(pNode, path);
+    TreeNode<T>* pCurrentNode = pNode->leftChild();
+    if (pCurrentNode == 0) {
+        pCurrentNode = pNode->rigthChild();
+    } else if (pNode->hasRigthChild()) {
+        // Chain the rigth subtree to the rigth end of the left subtree.
+        TreeNode<T>* pLastNode = pCurrentNode;
+        while (pLastNode->hasRigthChild()) {
+            pLastNode = pLastNode->rigthChild();
+        }
+        pLastNode->setRigthChild(pNode->rigthChild());
+    }
+    pNode->setLeftChild(NULL);
+    pNode->setRigthChild(NULL);
+    updateHeight(pNode);
+    while (pCurrentNode) {
+        if (pCurrentNode->hasLeftChild()) {
+            TreeNode<T>* pLeftNode = pCurrentNode->leftChild();
+            pCurrentNode->setLeftChild(pLeftNode->rigthChild());
+            pLeftNode->setRigthChild(pCurrentNode);
+            pCurrentNode = pLeftNode;
+        } else {
+            TreeNode<T>* pRigthNode = pCurrentNode->rigthChild();
+            destroyNode(pCurrentNode);
+            pCurrentNode = pRigthNode;
+        }
+    }
+    if (! isInTree) {
+        return;
+    }
+    bool isBalanced = true;
+    for (int index=path.size()-2; index>=0; --index) {
+        TreeNode<T>* pAncestor = path.at(index);
+        updateHeight(pAncestor);
+        int factor = heightOf(pAncestor->leftChild()) - heightOf(pAncestor->rigthChild());
+        isBalanced = isBalanced && factor >= -1 && factor <= 1;
+    }
+    if (m_balanceMode == AvlBalanced && ! isBalanced) {
+        rebuildBalanced();
+    }
+}
+
+/**
+ * Private
+ * Finds the path from root down to a node. Equal nodes can be in both
+ * subtrees of a node after rotations. So both subtrees are searched if
+ * a node is equal to the target.
+ * @param pTarget   The node to search for.
+ * @param path      Is set to the path. The last node is pTarget.
+ * @return          True if pTarget is a node of this tree.
+ */
+template<class T, template<class> class Allocator>
+bool BinaryTree<T, Allocator>::findPath(const TreeNode<T> * const pTarget, NodePath &path) const
+{
+    struct Entry {
+        TreeNode<T>* pNode;
+        int depth;
+    };
+    QVarLengthArray<Entry, 64> stack;
+    if (m_pRoot) {
+        Entry root = { m_pRoot, 0 };
+        stack.append(root);
+    }
+    while (! stack.isEmpty()) {
+        Entry entry = stack.last();
+        stack.removeLast();
+        path.resize(entry.depth);
+        path.append(entry.pNode);
+        if (entry.pNode == pTarget) {
+            return true;
+        }
+        CompareResult result = compareNodes(entry.pNode, pTarget);
+        if (result != Lesser && entry.pNode->hasRigthChild()) {
+            Entry rigth = { entry.pNode->rigthChild(), entry.depth + 1 };
+            stack.append(rigth);
+        }
+        if (result != Greater && entry.pNode->hasLeftChild()) {
+            Entry left = { entry.pNode->leftChild(), entry.depth + 1 };
+            stack.append(left);
+        }
+    }
+    path.clear();
+
+    return false;
+}
+
+/**
+ * Private
+ * Links nodes to a perfectly balanced tree. The middle node of each
+ * part becomes the root of this part. The heights are set.
+ * @param nodes     All nodes of the tree in order.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::linkBalanced(const NodeList &nodes)
+{
+    m_pRoot = 0;
+    // Link the middle node of each range to its parent.
+    struct Range {
+        int first;
+        int last;
+        TreeNode<T>* pParent;
+        bool isLeft;
+    };
+    QVarLengthArray<Range, 64> stack;
+    Range all = { 0, nodes.size(), 0, false };
+    stack.append(all);
+    while (! stack.isEmpty()) {
+        Range range = stack.last();
+        stack.removeLast();
+        if (range.first >= range.last) {
+            continue;
+        }
+        int middle = (range.first + range.last) / 2;
+        TreeNode<T>* pNode = nodes[middle];
+        pNode->setLeftChild(0);
+        pNode->setRigthChild(0);
+        int height = 0;
+        for (int size=range.last-range.first; size>0; size/=2) {
+            ++height;
+        }
+        pNode->setHeight(height);
+        if (range.pParent == 0) {
+            m_pRoot = pNode;
+        } else if (range.isLeft) {
+            range.pParent->setLeftChild(pNode);
+        } else {
+            range.pParent->setRigthChild(pNode);
+        }
+        Range left = { range.first, middle, pNode, true };
+        Range rigth = { middle + 1, range.last, pNode, false };
+        stack.append(left);
+        stack.append(rigth);
+    }
+}
+
+/**
+ * Private
+ * Links all nodes of the tree again to a perfectly balanced tree. The
+ * order of nodes is kept. No node is created or destroyed.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::rebuildBalanced()
+{
+    NodeList nodes;
+    iterator last = end();
+    for (iterator position = begin(); position != last; ++position) {
+        nodes.append(position.m_stack.last());
+    }
+    linkBalanced(nodes);
+}
+
+/**
+ * Private
+ * Destroys a node and gives its memory back to the allocator.
+ * @param pNode     The node.
+ */
+template<class T, template<class> class Allocator>
+void BinaryTree<T, Allocator>::destroyNode(TreeNode<T> *pNode)
+{
+    pNode->~TreeNode<T>();
+    m_allocator.deallocate(pNode);
 }
 
 
@@ -0,0 +1,149 @@
+#ifndef TREEITERATOR_H
+#define TREEITERATOR_H
+
+/**
+  * -------------------------------------------------------------------------------------------------------------
+  * Class: TreeIterator<T, Order>
+  * -------------------------------------------------------------------------------------------------------------
+  * An STL-style forward iterator over the nodes of a BinaryTree<T>. The order of traversal is a template
+  * parameter. The iterator keeps its path in an explicit stack instead of recursion. So even a degenerate
+  * tree with many levels can be traversed without a deep call stack.
+  *
+  * TraversalOrder::InOrder
+  *     Left subtree, node, rigth subtree. The user data objects are visited in ascending order.
+  * TraversalOrder::PreOrder
+  *     Node, left subtree, rigth subtree.
+  * TraversalOrder::PostOrder
+  *     Left subtree, rigth subtree, node.
+  *
+  * A default constructed iterator is the end iterator. The tree must not be changed while iterating.
+  */
+
+#include <treenode.h>
+#include <QVarLengthArray>
+#include <iterator>
+#include <cstddef>
+
+
+enum TraversalOrder { InOrder, PreOrder, PostOrder };
+
+template<class T, TraversalOrder Order>
+class TreeIterator
+{
+    template<class, template<class> class> friend class BinaryTree;
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    TreeIterator()                                          { }
+    explicit TreeIterator(TreeNode<T>* pRoot);
+
+    const T& operator * () const                            { return node()->userData(); }
+    const T* operator -> () const                           { return &node()->userData(); }
+    TreeIterator& operator ++ ();
+    TreeIterator operator ++ (int)                          { TreeIterator previous(*this); ++*this; return previous; }
+    bool operator == (const TreeIterator& rhs) const        { return node() == rhs.node(); }
+    bool operator != (const TreeIterator& rhs) const        { return node() != rhs.node(); }
+
+    const TreeNode<T>* node() const                         { return m_stack.isEmpty() ? 0 : m_stack.last(); }
+
+private:
+    void pushLeftPath(TreeNode<T>* pNode);
+    void pushFirstLeave(TreeNode<T>* pNode);
+
+    QVarLengthArray<TreeNode<T>*, 64> m_stack;
+};
+
+
+
+/**
+ * Constructs an iterator to the first node of a tree in the order of traversal.
+ * @param pRoot     The root node of the tree. Can be NULL.
+ */
+template<class T, TraversalOrder Order>
+TreeIterator<T, Order>::TreeIterator(TreeNode<T> *pRoot)
+{
+    if (pRoot == 0) {
+        return;
+    }
+    switch (Order) {
+    case InOrder:
+        pushLeftPath(pRoot);
+        break;
+    case PreOrder:
+        m_stack.append(pRoot);
+        break;
+    case PostOrder:
+        pushFirstLeave(pRoot);
+        break;
+    }
+}
+
+/**
+ * Moves the iterator to the next node in the order of traversal.
+ * @return          This iterator. Equal to the end iterator after the last node.
+ */
+template<class T, TraversalOrder Order>
+TreeIterator<T, Order> &TreeIterator<T, Order>::operator ++()
+{
+    TreeNode<T>* pNode = m_stack.last();
+    m_stack.removeLast();
+    switch (Order) {
+    case InOrder:
+        if (pNode->hasRigthChild()) {
+            pushLeftPath(pNode->rigthChild());
+        }
+        break;
+    case PreOrder:
+        if (pNode->hasRigthChild()) {
+            m_stack.append(pNode->rigthChild());
+        }
+        if (pNode->hasLeftChild()) {
+            m_stack.append(pNode->leftChild());
+        }
+        break;
+    case PostOrder:
+        // Coming up from a left child the rigth subtree of the parent comes next.
+        if (! m_stack.isEmpty() && m_stack.last()->leftChild() == pNode && m_stack.last()->hasRigthChild()) {
+            pushFirstLeave(m_stack.last()->rigthChild());
+        }
+        break;
+    }
+
+    return *this;
+}
+
+/**
+ * Private
+ * Pushes a node and all its left descendants onto the stack.
+ * @param pNode     The root of a subtree.
+ */
+template<class T, TraversalOrder Order>
+void TreeIterator<T, Order>::pushLeftPath(TreeNode<T> *pNode)
+{
+    while (pNode) {
+        m_stack.append(pNode);
+        pNode = pNode->leftChild();
+    }
+}
+
+/**
+ * Private
+ * Pushes the path down to the first leave in post-order. Walks left if
+ * possible and rigth otherwise.
+ * @param pNode     The root of a subtree.
+ */
+template<class T, TraversalOrder Order>
+void TreeIterator<T, Order>::pushFirstLeave(TreeNode<T> *pNode)
+{
+    while (pNode) {
+        m_stack.append(pNode);
+        pNode = pNode->hasLeftChild() ? pNode->leftChild() : pNode->rigthChild();
+    }
+}
+
+#endif // TREEITERATOR_H
@@ -16,10 +16,20 @@
   * If equal data should not take place in the tree as a own tree node then it needs to implement
   * an overload of operator <<. This operator overload should unit two tree nodes into one.
   * A 'toString()' method is required to get a string representation of the tree.
+  *
+  * userData() returns a reference to the data in the node. In former versions the non const
+  * userData() returned a copy. Code which changes the returned object now changes the node.
+  * Take a copy explicitly if the node must not change.
+  *
+  * Height
+  * ------
+  * Each node keeps the height of the subtree below it. A leave has a height of 1.
+  * The height is maintained by the BinaryTree class to balance the tree.
   */
 
 
 #include <QString>
+#include <utility>
 
 
 // This data type is returned when two nodes were compared.
@@ -32,12 +42,35 @@ public:
     TreeNode(const T& data) :
         m_data(data),
         m_pLeftChild(0),
-        m_pRigthChild(0)
+        m_pRigthChild(0),
+        m_height(1)
+    {
+
+    }
+
+    TreeNode(T&& data) :
+        m_data(std::move(data)),
+        m_pLeftChild(0),
+        m_pRigthChild(0),
+        m_height(1)
+    {
+
+    }
+
+    // Selects the constructor which constructs the user data in the node.
+    struct InPlace {};
+
+    template<class... Args>
+    TreeNode(InPlace, Args&&... args) :
+        m_data(std::forward<Args>(args)...),
+        m_pLeftChild(0),
+        m_pRigthChild(0),
+        m_height(1)
     {
 
     }
 
-    T userData()                                    { return m_data; }
+    T& userData()                                   { return m_data; }
     const T& userData() const                       { return m_data; }
     void setUserData(const T& data)                 { m_data = data; }
     T* ptrUserData()                                { return &m_data; }
@@ -50,6 +83,8 @@ public:
     void setRigthChild(TreeNode* pNode)             { m_pRigthChild = pNode; }
     TreeNode* leftChild() const                     { return m_pLeftChild; }
     TreeNode* rigthChild() const                    { return m_pRigthChild; }
+    int height() const                              { return m_height; }
+    void setHeight(const int height)                { m_height = height; }
 
     // Operator overload.
     void operator << (const TreeNode* const rhs)    { m_data << rhs->m_data; }
@@ -58,6 +93,7 @@ private:
     T m_data;
     TreeNode* m_pLeftChild;
     TreeNode* m_pRigthChild;
+    int m_height;
 };
 
 #endif // TREENODE_H
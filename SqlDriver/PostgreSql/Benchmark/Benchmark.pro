@@ -0,0 +1,42 @@
+#-------------------------------------------------
+#
+# Benchmark of the PostgreSql driver. Starts a
+# throwaway cluster with initdb on a free port.
+#
+#-------------------------------------------------
+
+QT       += sql network
+QT       -= gui
+
+TARGET = kqpostgresqlbenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += .. \
+    $$system(pg_config --includedir)
+LIBS += -L$$system(pg_config --libdir) -lpq
+
+SOURCES += main.cpp \
+    benchmarkcluster.cpp \
+    driverbenchmark.cpp \
+    ../kqpostgresqldriver.cpp \
+    ../kqpostgresqlresult.cpp \
+    ../kqpostgresqlcolumn.cpp \
+    ../kqpostgresqldatetime.cpp \
+    ../kqpostgresqldecimal.cpp \
+    ../kqpostgresqlbytea.cpp \
+    ../kqpostgresqlstatistics.cpp \
+    ../kqpostgresqlsyntheticresult.cpp
+
+HEADERS += benchmarkcluster.h \
+    driverbenchmark.h \
+    ../kqpostgresqldriver.h \
+    ../kqpostgresqlresult.h \
+    ../kqpostgresqlcolumn.h \
+    ../kqpostgresqldatetime.h \
+    ../kqpostgresqldecimal.h \
+    ../kqpostgresqlbytea.h \
+    ../kqpostgresqlstatistics.h \
+    ../kqpostgresqlsyntheticresult.h
@@ -0,0 +1,142 @@
+#include "benchmarkcluster.h"
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QDir>
+#include <QTcpServer>
+#include <QHostAddress>
+#include <QDebug>
+
+
+/**
+ * Constructor
+ * Looks up the directory of the PostgreSql programs.
+ */
+BenchmarkCluster::BenchmarkCluster() :
+    m_port(-1),
+    m_isRunning(false)
+{
+    m_binDir = QProcessEnvironment::systemEnvironment().value(QString("KQ_PG_BINDIR"));
+    if (m_binDir.isEmpty()) {
+        QProcess pgConfig;
+        pgConfig.start(QString("pg_config"), QStringList() << QString("--bindir"));
+        if (pgConfig.waitForFinished() && pgConfig.exitCode() == 0) {
+            m_binDir = QString::fromLocal8Bit(pgConfig.readAllStandardOutput()).trimmed();
+        }
+    }
+}
+
+/**
+ * Destructor
+ * Stops the server. The temporary directory is deleted.
+ */
+BenchmarkCluster::~BenchmarkCluster()
+{
+    stop();
+}
+
+/**
+ * Creates the cluster and starts the server. The server is tuned for
+ * a benchmark. It does not sync to disk.
+ * @return      True if the server accepts connections.
+ */
+bool BenchmarkCluster::start()
+{
+    if (m_isRunning) {
+        return true;
+    }
+    if (! m_directory.isValid()) {
+        m_errorString = QString("Could not create a temporary directory !");
+        return false;
+    }
+    QString dataDir = m_directory.path() + QString("/data");
+    QStringList initArguments;
+    initArguments << QString("-D") << dataDir << QString("-U") << user() << QString("-A") << QString("trust")
+                  << QString("-E") << QString("UTF8") << QString("--no-sync");
+    if (! run(QString("initdb"), initArguments)) {
+        return false;
+    }
+    m_port = freePort();
+    if (m_port < 0) {
+        m_errorString = QString("Could not find a free port !");
+        return false;
+    }
+    QString options = QString("-p %1 -k %2 -c listen_addresses=%3 -c fsync=off -c synchronous_commit=off")
+            .arg(m_port).arg(m_directory.path()).arg(host());
+    QStringList startArguments;
+    startArguments << QString("-D") << dataDir << QString("-o") << options
+                   << QString("-l") << m_directory.path() + QString("/server.log") << QString("-w") << QString("start");
+    if (! run(QString("pg_ctl"), startArguments)) {
+        return false;
+    }
+    m_isRunning = true;
+
+    return true;
+}
+
+/**
+ * Stops the server immediately.
+ */
+void BenchmarkCluster::stop()
+{
+    if (! m_isRunning) {
+        return;
+    }
+    QStringList arguments;
+    arguments << QString("-D") << m_directory.path() + QString("/data") << QString("-m") << QString("immediate")
+              << QString("-w") << QString("stop");
+    run(QString("pg_ctl"), arguments);
+    m_isRunning = false;
+}
+
+/**
+ * Private
+ * Get the path of a PostgreSql program.
+ * @param program       The program name.
+ * @return              The path or the name to search PATH.
+ */
+QString BenchmarkCluster::programPath(const QString &program) const
+{
+    if (m_binDir.isEmpty()) {
+        return program;
+    }
+
+    return QDir(m_binDir).filePath(program);
+}
+
+/**
+ * Private
+ * Runs a PostgreSql program and waits for it.
+ * @param program       The program name.
+ * @param arguments     The arguments.
+ * @return              True if the program exited with 0.
+ */
+bool BenchmarkCluster::run(const QString &program, const QStringList &arguments)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(programPath(program), arguments);
+    if (! process.waitForFinished(120000) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        m_errorString = QString("%1 failed: %2 %3").arg(program).arg(process.errorString())
+                .arg(QString::fromLocal8Bit(process.readAll()));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Private
+ * Finds a free TCP port on the loopback interface.
+ * @return      A port number or -1.
+ */
+int BenchmarkCluster::freePort()
+{
+    QTcpServer server;
+    if (! server.listen(QHostAddress::LocalHost, 0)) {
+        return -1;
+    }
+    int port = server.serverPort();
+    server.close();
+
+    return port;
+}
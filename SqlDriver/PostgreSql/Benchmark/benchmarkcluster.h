@@ -0,0 +1,49 @@
+#ifndef BENCHMARKCLUSTER_H
+#define BENCHMARKCLUSTER_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          BenchmarkCluster
+ * -------------------------------------------------------------------------------------
+ * A throwaway PostgreSql cluster for the benchmark. start() creates a cluster
+ * with initdb in a temporary directory and starts a server on a free TCP port
+ * of 127.0.0.1. The destructor stops the server and deletes the directory.
+ *
+ * The PostgreSql programs are taken from the directory in the environment
+ * variable KQ_PG_BINDIR, from 'pg_config --bindir' or from PATH. initdb does
+ * not run as root.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+
+
+class BenchmarkCluster
+{
+public:
+    BenchmarkCluster();
+    ~BenchmarkCluster();
+
+    bool start();
+    void stop();
+
+    QString host() const                                { return QString("127.0.0.1"); }
+    int port() const                                    { return m_port; }
+    QString user() const                                { return QString("postgres"); }
+    QString errorString() const                         { return m_errorString; }
+
+private:
+    QString programPath(const QString& program) const;
+    bool run(const QString& program, const QStringList& arguments);
+    static int freePort();
+
+private:
+    QTemporaryDir m_directory;
+    QString m_binDir;
+    int m_port;
+    bool m_isRunning;
+    QString m_errorString;
+};
+
+#endif // BENCHMARKCLUSTER_H
@@ -0,0 +1,572 @@
+#include "driverbenchmark.h"
+#include "kqpostgresqldatetime.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QVariant>
+#include <QVector>
+#include <QDebug>
+
+
+// Rows of the table for the decode and memory cases.
+static const int tableRows = 100000;
+
+// Rows of a block for the prefetch cases.
+static const int prefetchBlock = 100;
+
+// Columns of the decode table with their PostgreSql type.
+struct DecodeColumn {
+    const char* name;
+    const char* type;
+    Oid oid;
+};
+
+static const DecodeColumn decodeColumns[] = {
+    { "i4", "int4", 23 },
+    { "i8", "int8", 20 },
+    { "f8", "float8", 701 },
+    { "num", "numeric", 1700 },
+    { "txt", "text", 25 },
+    { "flag", "bool", 16 },
+    { "day", "date", 1082 },
+    { "ts", "timestamp", 1114 },
+    { "tstz", "timestamptz", 1184 },
+    { "bin", "bytea", 17 }
+};
+
+static const int decodeColumnCount = sizeof(decodeColumns) / sizeof(decodeColumns[0]);
+
+
+/**
+ * Constructor
+ * @param host          The host of the server.
+ * @param port          The port of the server.
+ * @param user          A user who can create tables.
+ */
+DriverBenchmark::DriverBenchmark(const QString &host, const int port, const QString &user) :
+    m_host(host),
+    m_port(port),
+    m_user(user),
+    m_connectionName(QString("kqpostgresqlbenchmark")),
+    m_pDriver(NULL),
+    m_syntheticRows(tableRows),
+    m_syntheticNullRatio(0.1)
+{
+
+}
+
+/**
+ * Destructor
+ * Closes the benchmark connection.
+ */
+DriverBenchmark::~DriverBenchmark()
+{
+    m_database.close();
+    m_database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+/**
+ * Sets the shape of the results for the synthetic cases.
+ * @param rows          The number of rows of each result.
+ * @param nullRatio     The ratio of NULL values. 0.1 is 10 %.
+ * @param types         Names of decode types like 'int4' or 'date'. All
+ *                      decode types if empty.
+ */
+void DriverBenchmark::setSyntheticShape(const int rows, const double nullRatio, const QStringList &types)
+{
+    m_syntheticRows = rows;
+    m_syntheticNullRatio = nullRatio;
+    m_syntheticTypes = types;
+}
+
+/**
+ * Runs all benchmark cases.
+ * @return      False if the server can not be used.
+ */
+bool DriverBenchmark::run()
+{
+    m_cases = QJsonArray();
+    benchParsers();
+    benchSynthetic();
+    benchConnect();
+    if (! open()) {
+        return false;
+    }
+    benchPrepare();
+    benchExec();
+    benchDecode();
+    benchInsert();
+    benchRowMemory();
+
+    return true;
+}
+
+/**
+ * Runs the cases which do not need a server. These are the parse
+ * and the synthetic cases.
+ */
+void DriverBenchmark::runWithoutServer()
+{
+    m_cases = QJsonArray();
+    benchParsers();
+    benchSynthetic();
+}
+
+/**
+ * Get the result of the last run.
+ * @return      The server version, all cases and the driver statistics.
+ */
+QJsonObject DriverBenchmark::toJson() const
+{
+    QJsonObject json;
+    json.insert(QString("server"), m_serverVersion);
+    json.insert(QString("cases"), m_cases);
+    if (m_pDriver != NULL && m_pDriver->statistics() != NULL) {
+        json.insert(QString("statistics"), m_pDriver->statistics()->toJson());
+    }
+
+    return json;
+}
+
+/**
+ * Private
+ * Opens the connection for all cases but 'connect'. Statistics of
+ * the driver are enabled. Creates the table for the decode cases.
+ * @return      True if the connection is open.
+ */
+bool DriverBenchmark::open()
+{
+    m_pDriver = new KQPostgreSqlDriver();
+    m_pDriver->setStatisticsEnabled(true);
+    m_database = QSqlDatabase::addDatabase(m_pDriver, m_connectionName);
+    m_database.setDatabaseName(QString("postgres"));
+    m_database.setUserName(m_user);
+    m_database.setHostName(m_host);
+    m_database.setPort(m_port);
+    if (! m_database.open()) {
+        m_errorString = m_database.lastError().text();
+        return false;
+    }
+    QSqlQuery query(m_database);
+    if (query.exec(QString("SHOW server_version")) && query.next()) {
+        m_serverVersion = query.value(0).toString();
+    }
+    QStringList columns;
+    for (int index=0; index<decodeColumnCount; ++index) {
+        columns << QString("%1 %2").arg(decodeColumns[index].name).arg(decodeColumns[index].type);
+    }
+    QString insert("INSERT INTO bench_types SELECT n, n * 1000003, n / 7.0, n / 3.0, md5(n::text), n % 2 = 0, "
+                   "date '2000-01-01' + n % 10000, timestamp '2000-01-01' + n * interval '1 second', "
+                   "timestamptz '2000-01-01 00:00+00' + n * interval '1 second', decode(md5(n::text), 'hex') "
+                   "FROM generate_series(1, %1) n");
+
+    return exec(QString("CREATE TABLE bench_types (%1)").arg(columns.join(QString(", "))))
+            && exec(insert.arg(tableRows))
+            && exec(QString("ALTER TABLE bench_types ADD PRIMARY KEY (i4)"))
+            && exec(QString("VACUUM ANALYZE bench_types"));
+}
+
+/**
+ * Private
+ * Executes a statement of the benchmark setup.
+ * @param statement     The SQL statement.
+ * @return              True if done.
+ */
+bool DriverBenchmark::exec(const QString &statement)
+{
+    QSqlQuery query(m_database);
+    if (! query.exec(statement)) {
+        m_errorString = query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Private
+ * Date and timestamp parsing. KQPostgreSqlDateTime reads the text in
+ * place. The Qt parser needs a QString of each value.
+ */
+void DriverBenchmark::benchParsers()
+{
+    const int count = 200000;
+    const char* dates[] = { "2017-03-21", "1999-12-31", "0044-03-15 BC", "2024-02-29" };
+    const char* timestamps[] = { "2017-03-21 19:31:32.123456", "1999-12-31 23:59:59", "2024-02-29 00:00:00.5",
+                                 "2000-01-01 12:00:00.25" };
+    const char* timestampsTz[] = { "2017-03-21 19:31:32.123456+01", "1999-12-31 23:59:59-08",
+                                   "2024-02-29 00:00:00.5+05:30", "2000-01-01 12:00:00.25+00" };
+    int valid = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int index=0; index<count; ++index) {
+        QDate date;
+        valid += KQPostgreSqlDateTime::parseDate(dates[index % 4], date) ? 1 : 0;
+    }
+    addCase(QString("parse.date"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        valid += QDate::fromString(QString(dates[index % 4]), Qt::ISODate).isValid() ? 1 : 0;
+    }
+    addCase(QString("fromString.date"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        QDateTime dateTime;
+        valid += KQPostgreSqlDateTime::parseDateTime(timestamps[index % 4], dateTime) ? 1 : 0;
+    }
+    addCase(QString("parse.timestamp"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        valid += QDateTime::fromString(QString(timestamps[index % 4]), Qt::ISODate).isValid() ? 1 : 0;
+    }
+    addCase(QString("fromString.timestamp"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        QDateTime dateTime;
+        valid += KQPostgreSqlDateTime::parseDateTime(timestampsTz[index % 4], dateTime) ? 1 : 0;
+    }
+    addCase(QString("parse.timestamptz"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        valid += QDateTime::fromString(QString(timestampsTz[index % 4]), Qt::ISODate).isValid() ? 1 : 0;
+    }
+    addCase(QString("fromString.timestamptz"), count, timer.nsecsElapsed() / 1000);
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        qint64 microseconds = 0;
+        valid += KQPostgreSqlDateTime::parseMicroseconds(timestampsTz[index % 4], microseconds) ? 1 : 0;
+    }
+    addCase(QString("parse.microseconds"), count, timer.nsecsElapsed() / 1000);
+    // Keeps the loops from being optimized away.
+    if (valid == 0) {
+        qWarning() << "Benchmark: No value was parsed.";
+    }
+}
+
+/**
+ * Private
+ * Connect latency. Each connection is opened and closed by its own
+ * driver.
+ */
+void DriverBenchmark::benchConnect()
+{
+    const int count = 50;
+    QElapsedTimer timer;
+    timer.start();
+    int connected = 0;
+    for (int index=0; index<count; ++index) {
+        KQPostgreSqlDriver driver;
+        if (driver.open(QString("postgres"), m_user, QString(), m_host, m_port)) {
+            ++connected;
+        }
+        driver.close();
+    }
+    addCase(QString("connect"), connected, timer.nsecsElapsed() / 1000);
+}
+
+/**
+ * Private
+ * Prepare throughput. Each statement has its own text. So each one
+ * is prepared by the server.
+ */
+void DriverBenchmark::benchPrepare()
+{
+    const int count = 1000;
+    QSqlQuery query(m_database);
+    QElapsedTimer timer;
+    timer.start();
+    for (int index=0; index<count; ++index) {
+        query.prepare(QString("SELECT i8 FROM bench_types WHERE i4 = ? AND i8 > %1").arg(index));
+    }
+    addCase(QString("prepare"), count, timer.nsecsElapsed() / 1000);
+}
+
+/**
+ * Private
+ * Exec throughput of a simple statement and of a prepared statement.
+ */
+void DriverBenchmark::benchExec()
+{
+    const int count = 5000;
+    QSqlQuery query(m_database);
+    QElapsedTimer timer;
+    timer.start();
+    for (int index=0; index<count; ++index) {
+        query.exec(QString("SELECT 1"));
+    }
+    addCase(QString("exec.simple"), count, timer.nsecsElapsed() / 1000);
+
+    query.prepare(QString("SELECT txt FROM bench_types WHERE i4 = ?"));
+    timer.restart();
+    for (int index=0; index<count; ++index) {
+        query.bindValue(0, index % tableRows + 1);
+        query.exec();
+    }
+    addCase(QString("exec.prepared"), count, timer.nsecsElapsed() / 1000);
+}
+
+/**
+ * Private
+ * Decode rate for each column type. The time covers next() and
+ * value() of all rows. The statement is executed before the timer
+ * starts.
+ */
+void DriverBenchmark::benchDecode()
+{
+    for (int index=0; index<decodeColumnCount; ++index) {
+        const DecodeColumn& column = decodeColumns[index];
+        QSqlQuery query(m_database);
+        query.setForwardOnly(true);
+        if (! query.exec(QString("SELECT %1 FROM bench_types").arg(column.name))) {
+            qWarning() << "Benchmark: " << query.lastError().text();
+            continue;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        int rows = 0;
+        while (query.next()) {
+            QVariant value = query.value(0);
+            if (value.isValid()) {
+                ++rows;
+            }
+        }
+        QJsonObject details;
+        details.insert(QString("oid"), (int)column.oid);
+        addCase(QString("decode.%1").arg(column.type), rows, timer.nsecsElapsed() / 1000, details);
+    }
+}
+
+/**
+ * Private
+ * Bulk insert. Rows are inserted one by one with a prepared statement
+ * and all at once with upsert(). The upsert runs twice. The second run
+ * updates all rows.
+ */
+void DriverBenchmark::benchInsert()
+{
+    exec(QString("CREATE TABLE bench_insert (id int4 PRIMARY KEY, name text, value float8)"));
+    const int preparedRows = 5000;
+    QSqlQuery query(m_database);
+    query.prepare(QString("INSERT INTO bench_insert (id, name, value) VALUES (?, ?, ?)"));
+    QElapsedTimer timer;
+    timer.start();
+    for (int row=0; row<preparedRows; ++row) {
+        query.bindValue(0, -row - 1);
+        query.bindValue(1, QString("name %1").arg(row));
+        query.bindValue(2, row * 0.5);
+        query.exec();
+    }
+    addCase(QString("insert.prepared"), preparedRows, timer.nsecsElapsed() / 1000);
+
+    const int upsertRows = 100000;
+    QVector<QVector<QVariant> > rows;
+    rows.reserve(upsertRows);
+    for (int row=0; row<upsertRows; ++row) {
+        QVector<QVariant> values;
+        values << row << QString("name %1").arg(row) << row * 0.5;
+        rows << values;
+    }
+    QStringList columns;
+    columns << QString("id") << QString("name") << QString("value");
+    for (int pass=0; pass<2; ++pass) {
+        timer.restart();
+        QSqlQuery result = m_pDriver->upsert(QString("bench_insert"), columns, rows, QStringList() << QString("id"));
+        if (result.lastError().isValid()) {
+            qWarning() << "Benchmark: " << result.lastError().text();
+            return;
+        }
+        addCase(pass == 0 ? QString("insert.upsert") : QString("update.upsert"), upsertRows, timer.nsecsElapsed() / 1000);
+    }
+}
+
+/**
+ * Private
+ * Memory per fetched row. The driver counts the bytes of the results
+ * which are held by queries.
+ */
+void DriverBenchmark::benchRowMemory()
+{
+    qint64 bytesBefore = m_pDriver->resultBytes();
+    QSqlQuery query(m_database);
+    QElapsedTimer timer;
+    timer.start();
+    if (! query.exec(QString("SELECT * FROM bench_types"))) {
+        qWarning() << "Benchmark: " << query.lastError().text();
+        return;
+    }
+    qint64 microseconds = timer.nsecsElapsed() / 1000;
+    int rows = query.size();
+    qint64 bytes = m_pDriver->resultBytes() - bytesBefore;
+    QJsonObject details;
+    details.insert(QString("bytes"), (double)bytes);
+    details.insert(QString("bytesPerRow"), rows > 0 ? (double)bytes / rows : 0.0);
+    addCase(QString("memory.row"), rows, microseconds, details);
+}
+
+/**
+ * Private
+ * Decode rate of results which are built in the process. There is
+ * no server and no network. So the time is spent in fetch() and
+ * data() of KQPostgreSqlResult only. Each selected type is read from
+ * its own result. Then all types are read from one result.
+ */
+void DriverBenchmark::benchSynthetic()
+{
+    KQPostgreSqlSyntheticResult rowShape(m_syntheticRows);
+    rowShape.setNullRatio(m_syntheticNullRatio);
+    for (int index=0; index<decodeColumnCount; ++index) {
+        const DecodeColumn& column = decodeColumns[index];
+        if (! m_syntheticTypes.isEmpty() && ! m_syntheticTypes.contains(QString(column.type))) {
+            continue;
+        }
+        KQPostgreSqlSyntheticResult shape(m_syntheticRows);
+        shape.setNullRatio(m_syntheticNullRatio);
+        shape.addColumn(QString(column.name), column.oid);
+        fetchSynthetic(QString("synthetic.%1").arg(column.type), shape);
+        rowShape.addColumn(QString(column.name), column.oid);
+    }
+    if (rowShape.columns() > 0) {
+        fetchSynthetic(QString("synthetic.row"), rowShape);
+        benchPrefetch(rowShape);
+    }
+}
+
+/**
+ * Private
+ * Reads all values of a synthetic result with next() and value().
+ * The result is built before the timer starts. The count of the
+ * case is the number of values.
+ * @param name          The name of the case.
+ * @param shape         The shape of the result.
+ */
+void DriverBenchmark::fetchSynthetic(const QString &name, const KQPostgreSqlSyntheticResult &shape)
+{
+    KQPostgreSqlDriver driver;
+    PGresult* pResult = shape.create();
+    if (pResult == NULL) {
+        qWarning() << "Benchmark: Could not create a synthetic result.";
+        return;
+    }
+    qint64 values = 0;
+    qint64 microseconds = 0;
+    {
+        QSqlQuery query = driver.createQuery(pResult);
+        int columns = shape.columns();
+        QElapsedTimer timer;
+        timer.start();
+        while (query.next()) {
+            for (int column=0; column<columns; ++column) {
+                QVariant value = query.value(column);
+                if (value.isValid()) {
+                    ++values;
+                }
+            }
+        }
+        microseconds = timer.nsecsElapsed() / 1000;
+    }
+    QJsonObject details;
+    details.insert(QString("rows"), shape.rows());
+    details.insert(QString("columns"), shape.columns());
+    details.insert(QString("nullRatio"), m_syntheticNullRatio);
+    addCase(name, values, microseconds, details);
+}
+
+/**
+ * Private
+ * Row prefetch against decoding in data(). The rows of the result
+ * are visited in forward, backward and random order. Each order runs
+ * with and without prefetch.
+ * @param shape         The shape of the result.
+ */
+void DriverBenchmark::benchPrefetch(const KQPostgreSqlSyntheticResult &shape)
+{
+    int rowCount = shape.rows();
+    QVector<int> forward(rowCount);
+    QVector<int> backward(rowCount);
+    for (int row=0; row<rowCount; ++row) {
+        forward[row] = row;
+        backward[row] = rowCount - 1 - row;
+    }
+    QVector<int> random;
+    random.reserve(rowCount);
+    quint32 state = 1;
+    for (int index=0; index<rowCount; ++index) {
+        state = state * 1664525u + 1013904223u;
+        int row = (int)((state >> 8) % rowCount);
+        if (random.isEmpty() || random.last() != row) {
+            random.append(row);
+        }
+    }
+    const char* orders[] = { "forward", "backward", "random" };
+    const QVector<int>* rows[] = { &forward, &backward, &random };
+    for (int index=0; index<3; ++index) {
+        seekSynthetic(QString("prefetch.%1").arg(orders[index]), shape, prefetchBlock, *rows[index]);
+        seekSynthetic(QString("uncached.%1").arg(orders[index]), shape, 0, *rows[index]);
+    }
+}
+
+/**
+ * Private
+ * Reads all values of the given rows of a synthetic result with
+ * seek() and value(). The count of the case is the number of values.
+ * @param name          The name of the case.
+ * @param shape         The shape of the result.
+ * @param prefetch      The rows of a prefetch block. 0 for no prefetch.
+ * @param rows          The row numbers in the order of the seeks.
+ */
+void DriverBenchmark::seekSynthetic(const QString &name, const KQPostgreSqlSyntheticResult &shape, const int prefetch,
+                                    const QVector<int> &rows)
+{
+    KQPostgreSqlDriver driver;
+    driver.setRowPrefetch(prefetch);
+    PGresult* pResult = shape.create();
+    if (pResult == NULL) {
+        qWarning() << "Benchmark: Could not create a synthetic result.";
+        return;
+    }
+    qint64 values = 0;
+    qint64 microseconds = 0;
+    {
+        QSqlQuery query = driver.createQuery(pResult);
+        int columns = shape.columns();
+        QElapsedTimer timer;
+        timer.start();
+        foreach (int row, rows) {
+            if (! query.seek(row)) {
+                continue;
+            }
+            for (int column=0; column<columns; ++column) {
+                QVariant value = query.value(column);
+                if (value.isValid()) {
+                    ++values;
+                }
+            }
+        }
+        microseconds = timer.nsecsElapsed() / 1000;
+    }
+    QJsonObject details;
+    details.insert(QString("rows"), rows.size());
+    details.insert(QString("prefetch"), prefetch);
+    details.insert(QString("nullRatio"), m_syntheticNullRatio);
+    addCase(name, values, microseconds, details);
+}
+
+/**
+ * Private
+ * Adds the result of a case.
+ * @param name              The name of the case.
+ * @param count             The number of operations.
+ * @param microseconds      The time of all operations.
+ * @param details           Further values of the case.
+ */
+void DriverBenchmark::addCase(const QString &name, const qint64 count, const qint64 microseconds,
+                              const QJsonObject &details)
+{
+    QJsonObject benchCase = details;
+    benchCase.insert(QString("name"), name);
+    benchCase.insert(QString("count"), (double)count);
+    benchCase.insert(QString("microseconds"), (double)microseconds);
+    benchCase.insert(QString("perSecond"), microseconds > 0 ? count * 1000000.0 / microseconds : 0.0);
+    m_cases.append(benchCase);
+}
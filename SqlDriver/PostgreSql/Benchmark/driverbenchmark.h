@@ -0,0 +1,93 @@
+#ifndef DRIVERBENCHMARK_H
+#define DRIVERBENCHMARK_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          DriverBenchmark
+ * -------------------------------------------------------------------------------------
+ * Benchmark cases for the hot paths of KQPostgreSqlDriver. The cases run
+ * against a server which is reachable by host and port. The parse and the
+ * synthetic cases run without a server. runWithoutServer() runs only them.
+ *
+ * parse.<type>         Parse values with KQPostgreSqlDateTime.
+ * fromString.<type>    Parse the same values with Qt::ISODate from a QString.
+ *                      This was the decoding before KQPostgreSqlDateTime.
+ * connect              Open and close a connection.
+ * prepare              Prepare distinct statements.
+ * exec.simple          Execute a statement without parameters.
+ * exec.prepared        Execute a prepared statement with one parameter.
+ * decode.<type>        Read all values of a column with QSqlQuery::value().
+ * insert.prepared      Insert rows one by one with a prepared statement.
+ * insert.upsert        Insert rows with KQPostgreSqlDriver::upsert().
+ * memory.row           Result memory per fetched row of a wide table.
+ * synthetic.<type>     Read all values of a KQPostgreSqlSyntheticResult column
+ *                      with QSqlQuery::next() and QSqlQuery::value().
+ * synthetic.row        Read all values of a result with all synthetic columns.
+ * prefetch.<order>     Read all values of the synthetic.row result with seek()
+ *                      in forward, backward or random order. Blocks of 100
+ *                      rows are prefetched.
+ * uncached.<order>     The same without row prefetch.
+ *
+ * The synthetic results have 100000 rows of all decode types and 10 % NULL
+ * values. setSyntheticShape() changes the rows, the types and the ratio.
+ *
+ * Each case has a count, the time in microseconds and the rate per second.
+ * toJson() returns all cases and the statistics of the driver. The JSON of
+ * two builds can be compared to find regressions.
+ */
+
+#include "kqpostgresqldriver.h"
+#include "kqpostgresqlsyntheticresult.h"
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSqlDatabase>
+#include <QStringList>
+
+
+class DriverBenchmark
+{
+public:
+    DriverBenchmark(const QString& host, const int port, const QString& user);
+    ~DriverBenchmark();
+
+    void setSyntheticShape(const int rows, const double nullRatio, const QStringList& types = QStringList());
+    bool run();
+    void runWithoutServer();
+    QJsonObject toJson() const;
+    QJsonArray cases() const                            { return m_cases; }
+    QString errorString() const                         { return m_errorString; }
+
+private:
+    bool open();
+    bool exec(const QString& statement);
+    void benchParsers();
+    void benchConnect();
+    void benchPrepare();
+    void benchExec();
+    void benchDecode();
+    void benchInsert();
+    void benchRowMemory();
+    void benchSynthetic();
+    void fetchSynthetic(const QString& name, const KQPostgreSqlSyntheticResult& shape);
+    void benchPrefetch(const KQPostgreSqlSyntheticResult& shape);
+    void seekSynthetic(const QString& name, const KQPostgreSqlSyntheticResult& shape, const int prefetch,
+                       const QVector<int>& rows);
+    void addCase(const QString& name, const qint64 count, const qint64 microseconds,
+                 const QJsonObject& details = QJsonObject());
+
+private:
+    QString m_host;
+    int m_port;
+    QString m_user;
+    QString m_connectionName;
+    QSqlDatabase m_database;
+    KQPostgreSqlDriver* m_pDriver;
+    QString m_serverVersion;
+    int m_syntheticRows;
+    double m_syntheticNullRatio;
+    QStringList m_syntheticTypes;
+    QJsonArray m_cases;
+    QString m_errorString;
+};
+
+#endif // DRIVERBENCHMARK_H
@@ -0,0 +1,146 @@
+#include "benchmarkcluster.h"
+#include "driverbenchmark.h"
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+
+/**
+ * Reads a JSON file of a former run.
+ * @param fileName      The file name.
+ * @param json          Is set to the content.
+ * @return              True if file was read.
+ */
+static bool readJson(const QString& fileName, QJsonObject& json)
+{
+    QFile file(fileName);
+    if (! file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    json = QJsonDocument::fromJson(file.readAll()).object();
+
+    return ! json.isEmpty();
+}
+
+/**
+ * Compares the rates of two runs. A case is a regression if its rate
+ * drops by more than the tolerance.
+ * @param baseline      The JSON of a former run.
+ * @param current       The JSON of this run.
+ * @param tolerance     The allowed drop of the rate. 0.1 is 10 %.
+ * @return              The number of regressions.
+ */
+static int compareRuns(const QJsonObject& baseline, const QJsonObject& current, const double tolerance)
+{
+    QTextStream out(stdout);
+    QHash<QString, double> baselineRates;
+    foreach (const QJsonValue& value, baseline.value(QString("cases")).toArray()) {
+        QJsonObject benchCase = value.toObject();
+        baselineRates.insert(benchCase.value(QString("name")).toString(), benchCase.value(QString("perSecond")).toDouble());
+    }
+    int regressions = 0;
+    foreach (const QJsonValue& value, current.value(QString("cases")).toArray()) {
+        QJsonObject benchCase = value.toObject();
+        QString name = benchCase.value(QString("name")).toString();
+        double baselineRate = baselineRates.value(name, 0.0);
+        if (baselineRate <= 0.0) {
+            continue;
+        }
+        double ratio = benchCase.value(QString("perSecond")).toDouble() / baselineRate;
+        bool isRegression = ratio < 1.0 - tolerance;
+        if (isRegression) {
+            ++regressions;
+        }
+        out << name.leftJustified(24) << QString::number(ratio, 'f', 2) << "x"
+            << (isRegression ? "  REGRESSION" : "") << endl;
+    }
+
+    return regressions;
+}
+
+/**
+ * Runs the driver benchmark on a throwaway cluster.
+ *      kqpostgresqlbenchmark [--compare baseline.json] [--tolerance 0.1]
+ *                            [--rows 100000] [--null-ratio 0.1] [--types int4,date]
+ *                            [--no-server] [output.json]
+ * The result is written to output.json. With a baseline the rates are
+ * compared. The exit code is 1 if a case is slower than the tolerance.
+ * --rows, --null-ratio and --types set the shape of the synthetic results.
+ * With --no-server no cluster is started. Only the parse and the synthetic
+ * cases run.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    QString outputFile("kqpostgresqlbenchmark.json");
+    QString baselineFile;
+    double tolerance = 0.1;
+    int syntheticRows = 100000;
+    double nullRatio = 0.1;
+    QStringList types;
+    bool isWithoutServer = false;
+    for (int index=1; index<arguments.size(); ++index) {
+        const QString& argument = arguments.at(index);
+        if (argument == QString("--compare") && index + 1 < arguments.size()) {
+            baselineFile = arguments.at(++index);
+        } else if (argument == QString("--tolerance") && index + 1 < arguments.size()) {
+            tolerance = arguments.at(++index).toDouble();
+        } else if (argument == QString("--rows") && index + 1 < arguments.size()) {
+            syntheticRows = arguments.at(++index).toInt();
+        } else if (argument == QString("--null-ratio") && index + 1 < arguments.size()) {
+            nullRatio = arguments.at(++index).toDouble();
+        } else if (argument == QString("--types") && index + 1 < arguments.size()) {
+            types = arguments.at(++index).split(QChar(','), QString::SkipEmptyParts);
+        } else if (argument == QString("--no-server")) {
+            isWithoutServer = true;
+        } else {
+            outputFile = argument;
+        }
+    }
+    QTextStream out(stdout);
+    QJsonObject result;
+    if (isWithoutServer) {
+        DriverBenchmark benchmark(QString(), 0, QString());
+        benchmark.setSyntheticShape(syntheticRows, nullRatio, types);
+        benchmark.runWithoutServer();
+        result = benchmark.toJson();
+    } else {
+        BenchmarkCluster cluster;
+        if (! cluster.start()) {
+            out << "Could not start cluster: " << cluster.errorString() << endl;
+            return 2;
+        }
+        DriverBenchmark benchmark(cluster.host(), cluster.port(), cluster.user());
+        benchmark.setSyntheticShape(syntheticRows, nullRatio, types);
+        if (! benchmark.run()) {
+            out << "Benchmark failed: " << benchmark.errorString() << endl;
+            return 2;
+        }
+        result = benchmark.toJson();
+    }
+    foreach (const QJsonValue& value, result.value(QString("cases")).toArray()) {
+        QJsonObject benchCase = value.toObject();
+        out << benchCase.value(QString("name")).toString().leftJustified(24)
+            << QString::number(benchCase.value(QString("perSecond")).toDouble(), 'f', 0) << " / s" << endl;
+    }
+    QFile file(outputFile);
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        out << "Could not write " << outputFile << endl;
+        return 2;
+    }
+    file.write(QJsonDocument(result).toJson());
+    file.close();
+    if (baselineFile.isEmpty()) {
+        return 0;
+    }
+    QJsonObject baseline;
+    if (! readJson(baselineFile, baseline)) {
+        out << "Could not read " << baselineFile << endl;
+        return 2;
+    }
+
+    return compareRuns(baseline, result, tolerance) > 0 ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+#-------------------------------------------------
+#
+# Unit tests of the PostgreSql driver. The tested
+# classes work without a database server. Results
+# are built by KQPostgreSqlSyntheticResult.
+#
+#-------------------------------------------------
+
+QT       += testlib sql
+QT       -= gui
+
+TARGET = tst_kqpostgresql
+CONFIG   += console testcase
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += .. \
+    $$system(pg_config --includedir)
+LIBS += -L$$system(pg_config --libdir) -lpq
+
+SOURCES += main.cpp \
+    tst_kqpostgresqlcolumn.cpp \
+    tst_kqpostgresqldecimal.cpp \
+    tst_kqpostgresqldatetime.cpp \
+    tst_kqpostgresqlbytea.cpp \
+    tst_kqpostgresqlsyntheticresult.cpp \
+    tst_kqpostgresqlrowprefetch.cpp \
+    ../kqpostgresqlcolumn.cpp \
+    ../kqpostgresqldatetime.cpp \
+    ../kqpostgresqlbytea.cpp \
+    ../kqpostgresqldecimal.cpp \
+    ../kqpostgresqlsyntheticresult.cpp \
+    ../kqpostgresqldriver.cpp \
+    ../kqpostgresqlresult.cpp \
+    ../kqpostgresqlstatistics.cpp
+
+HEADERS += tst_kqpostgresqlcolumn.h \
+    tst_kqpostgresqldecimal.h \
+    tst_kqpostgresqldatetime.h \
+    tst_kqpostgresqlbytea.h \
+    tst_kqpostgresqlsyntheticresult.h \
+    tst_kqpostgresqlrowprefetch.h \
+    ../kqpostgresqldriver.h \
+    ../kqpostgresqlresult.h
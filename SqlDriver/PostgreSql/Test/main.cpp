@@ -0,0 +1,30 @@
+#include "tst_kqpostgresqlcolumn.h"
+#include "tst_kqpostgresqldecimal.h"
+#include "tst_kqpostgresqldatetime.h"
+#include "tst_kqpostgresqlbytea.h"
+#include "tst_kqpostgresqlsyntheticresult.h"
+#include "tst_kqpostgresqlrowprefetch.h"
+#include <QtTest>
+
+
+/**
+ * Runs all test classes of the driver.
+ */
+int main(int argc, char *argv[])
+{
+    int status = 0;
+    TestKQPostgreSqlColumn columnTest;
+    status |= QTest::qExec(&columnTest, argc, argv);
+    TestKQPostgreSqlDecimal decimalTest;
+    status |= QTest::qExec(&decimalTest, argc, argv);
+    TestKQPostgreSqlDateTime dateTimeTest;
+    status |= QTest::qExec(&dateTimeTest, argc, argv);
+    TestKQPostgreSqlBytea byteaTest;
+    status |= QTest::qExec(&byteaTest, argc, argv);
+    TestKQPostgreSqlSyntheticResult syntheticResultTest;
+    status |= QTest::qExec(&syntheticResultTest, argc, argv);
+    TestKQPostgreSqlRowPrefetch rowPrefetchTest;
+    status |= QTest::qExec(&rowPrefetchTest, argc, argv);
+
+    return status;
+}
@@ -0,0 +1,81 @@
+#include "tst_kqpostgresqlbytea.h"
+#include "kqpostgresqlbytea.h"
+#include <QtTest>
+#include <cstring>
+
+
+/**
+ * Two hex digits give one byte. All byte values are decoded.
+ */
+void TestKQPostgreSqlBytea::decodeHex()
+{
+    const char* text = "\\x00017f80feff";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QCOMPARE(bytes.size(), 6);
+    QCOMPARE(bytes, QByteArray("\x00\x01\x7f\x80\xfe\xff", 6));
+}
+
+/**
+ * Hex digits can be upper case.
+ */
+void TestKQPostgreSqlBytea::decodeHexUpperCase()
+{
+    const char* text = "\\xDEADBEEF";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QCOMPARE(bytes, QByteArray("\xde\xad\xbe\xef", 4));
+}
+
+/**
+ * An empty value has the prefix only.
+ */
+void TestKQPostgreSqlBytea::decodeEmpty()
+{
+    const char* text = "\\x";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QVERIFY(bytes.isEmpty());
+}
+
+/**
+ * The escape format has octal escapes and doubled backslashes.
+ */
+void TestKQPostgreSqlBytea::decodeEscape()
+{
+    const char* text = "ab\\000\\\\c\\377";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QCOMPARE(bytes, QByteArray("ab\x00\\c\xff", 6));
+}
+
+/**
+ * decodeHex() fails if a character is no hex digit. Also at the
+ * low digit of the last byte.
+ */
+void TestKQPostgreSqlBytea::rejectInvalidDigit()
+{
+    char buffer[2];
+    QVERIFY(KQPostgreSqlBytea::decodeHex("0aF0", 2, buffer));
+    QVERIFY(! KQPostgreSqlBytea::decodeHex("0g00", 2, buffer));
+    QVERIFY(! KQPostgreSqlBytea::decodeHex("000x", 2, buffer));
+    QVERIFY(! KQPostgreSqlBytea::decodeHex(" 000", 2, buffer));
+}
+
+/**
+ * A hex value with an invalid digit is decoded by libpq. It skips
+ * the pair with the invalid digit.
+ */
+void TestKQPostgreSqlBytea::decodeInvalidDigit()
+{
+    const char* text = "\\x01zz02";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QCOMPARE(bytes, QByteArray("\x01\x02", 2));
+}
+
+/**
+ * A hex value with an odd number of digits is decoded by libpq. The
+ * last digit is dropped.
+ */
+void TestKQPostgreSqlBytea::decodeOddLength()
+{
+    const char* text = "\\x123";
+    QByteArray bytes = KQPostgreSqlBytea::decode(text, (int)strlen(text));
+    QCOMPARE(bytes, QByteArray("\x12", 1));
+}
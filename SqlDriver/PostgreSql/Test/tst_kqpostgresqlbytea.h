@@ -0,0 +1,29 @@
+#ifndef TST_KQPOSTGRESQLBYTEA_H
+#define TST_KQPOSTGRESQLBYTEA_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlBytea
+ * -------------------------------------------------------------------------------------
+ * Tests of KQPostgreSqlBytea. Decodes bytea values in hex and escape
+ * format as the server sends them.
+ */
+
+#include <QObject>
+
+
+class TestKQPostgreSqlBytea : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeHex();
+    void decodeHexUpperCase();
+    void decodeEmpty();
+    void decodeEscape();
+    void rejectInvalidDigit();
+    void decodeInvalidDigit();
+    void decodeOddLength();
+};
+
+#endif // TST_KQPOSTGRESQLBYTEA_H
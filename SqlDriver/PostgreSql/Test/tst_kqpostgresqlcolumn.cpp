@@ -0,0 +1,163 @@
+#include "tst_kqpostgresqlcolumn.h"
+#include "kqpostgresqlcolumn.h"
+#include <QtTest>
+#include <cstring>
+
+
+/**
+ * Values of an int4 column. A NULL has a cleared validity bit
+ * and the value zero.
+ */
+void TestKQPostgreSqlColumn::integerColumn()
+{
+    PGresult* pResult = createResult(23, QVector<const char*>() << "42" << NULL << "-7");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::Int32);
+    QCOMPARE(column.name(), QString("value"));
+    QCOMPARE(column.length(), 3);
+    QCOMPARE(column.nullCount(), 1);
+    QVERIFY(! column.isNull(0));
+    QVERIFY(column.isNull(1));
+    QVERIFY(! column.isNull(2));
+    QCOMPARE(column.data<qint32>()[0], 42);
+    QCOMPARE(column.data<qint32>()[1], 0);
+    QCOMPARE(column.data<qint32>()[2], -7);
+}
+
+/**
+ * Boolean values are packed as bits.
+ */
+void TestKQPostgreSqlColumn::booleanColumn()
+{
+    PGresult* pResult = createResult(16, QVector<const char*>() << "t" << "f" << "t");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::Boolean);
+    QCOMPARE(column.values().size(), 1);
+    QCOMPARE((int)column.values().at(0), 5);
+}
+
+/**
+ * Dates are days since 1970-01-01. BC dates are negative.
+ */
+void TestKQPostgreSqlColumn::dateColumn()
+{
+    PGresult* pResult = createResult(1082, QVector<const char*>() << "1970-01-01" << "2017-03-21" << "0001-01-01 BC");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::Date32);
+    QCOMPARE(column.nullCount(), 0);
+    QCOMPARE(column.data<qint32>()[0], 0);
+    QCOMPARE(column.data<qint32>()[1], 17246);
+    QCOMPARE(column.data<qint32>()[2], -719528);
+}
+
+/**
+ * A date which can not be parsed is NULL.
+ */
+void TestKQPostgreSqlColumn::infiniteDateIsNull()
+{
+    PGresult* pResult = createResult(1082, QVector<const char*>() << "infinity" << "2017-03-21" << "-infinity");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.nullCount(), 2);
+    QVERIFY(column.isNull(0));
+    QVERIFY(! column.isNull(1));
+    QVERIFY(column.isNull(2));
+    QCOMPARE(column.data<qint32>()[0], 0);
+    QCOMPARE(column.data<qint32>()[2], 0);
+}
+
+/**
+ * A timestamp which can not be parsed is NULL. A timestamp with
+ * offset is converted to UTC.
+ */
+void TestKQPostgreSqlColumn::infiniteTimestampIsNull()
+{
+    PGresult* pResult = createResult(1184, QVector<const char*>() << "1970-01-01 01:00:00.5+01" << "infinity");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::TimestampMicro);
+    QCOMPARE(column.nullCount(), 1);
+    QCOMPARE(column.data<qint64>()[0], Q_INT64_C(500000));
+    QVERIFY(column.isNull(1));
+    QCOMPARE(column.data<qint64>()[1], Q_INT64_C(0));
+}
+
+/**
+ * Text values are stored one after another. A NULL has an
+ * empty range.
+ */
+void TestKQPostgreSqlColumn::textOffsets()
+{
+    PGresult* pResult = createResult(25, QVector<const char*>() << "a" << NULL << "bcd" << "");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::Utf8);
+    QCOMPARE(column.values(), QByteArray("abcd"));
+    QCOMPARE(column.offsets().size(), 5 * (int)sizeof(qint32));
+    const qint32* offsets = reinterpret_cast<const qint32*>(column.offsets().constData());
+    QCOMPARE(offsets[0], 0);
+    QCOMPARE(offsets[1], 1);
+    QCOMPARE(offsets[2], 1);
+    QCOMPARE(offsets[3], 4);
+    QCOMPARE(offsets[4], 4);
+    QVERIFY(column.isNull(1));
+    QVERIFY(! column.isNull(3));
+}
+
+/**
+ * Bytea values in hex and in escape format are decoded.
+ */
+void TestKQPostgreSqlColumn::byteaValues()
+{
+    PGresult* pResult = createResult(17, QVector<const char*>() << "\\x00ff41" << "a\\000b" << "\\x");
+    KQPostgreSqlColumn column;
+    QVERIFY(KQPostgreSqlColumn::fromResult(pResult, 0, column));
+    PQclear(pResult);
+    QCOMPARE(column.type(), KQPostgreSqlColumn::Binary);
+    QCOMPARE(column.values(), QByteArray("\x00\xff" "Aa\x00" "b", 6));
+    const qint32* offsets = reinterpret_cast<const qint32*>(column.offsets().constData());
+    QCOMPARE(offsets[1], 3);
+    QCOMPARE(offsets[2], 6);
+    QCOMPARE(offsets[3], 6);
+}
+
+/**
+ * Private
+ * Builds a result with one column named 'value'.
+ * @param type          The PostgreSql type of the column.
+ * @param values        The values in text format. NULL for a NULL value.
+ * @return              A result with status PGRES_TUPLES_OK.
+ */
+PGresult *TestKQPostgreSqlColumn::createResult(const Oid type, const QVector<const char *> &values)
+{
+    PGresult* pResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    char name[] = "value";
+    PGresAttDesc attribute;
+    attribute.name = name;
+    attribute.tableid = 0;
+    attribute.columnid = 0;
+    attribute.format = 0;
+    attribute.typid = type;
+    attribute.typlen = -1;
+    attribute.atttypmod = -1;
+    PQsetResultAttrs(pResult, 1, &attribute);
+    for (int row=0; row<values.size(); ++row) {
+        const char* value = values.at(row);
+        if (value == NULL) {
+            PQsetvalue(pResult, row, 0, NULL, -1);
+        } else {
+            PQsetvalue(pResult, row, 0, const_cast<char*>(value), (int)strlen(value));
+        }
+    }
+
+    return pResult;
+}
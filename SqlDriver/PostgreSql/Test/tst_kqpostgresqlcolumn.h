@@ -0,0 +1,34 @@
+#ifndef TST_KQPOSTGRESQLCOLUMN_H
+#define TST_KQPOSTGRESQLCOLUMN_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlColumn
+ * -------------------------------------------------------------------------------------
+ * Tests of KQPostgreSqlColumn. The results are built in the process with
+ * PQsetvalue(). No server is needed.
+ */
+
+#include <libpq-fe.h>
+#include <QObject>
+#include <QVector>
+
+
+class TestKQPostgreSqlColumn : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void integerColumn();
+    void booleanColumn();
+    void dateColumn();
+    void infiniteDateIsNull();
+    void infiniteTimestampIsNull();
+    void textOffsets();
+    void byteaValues();
+
+private:
+    static PGresult* createResult(const Oid type, const QVector<const char*>& values);
+};
+
+#endif // TST_KQPOSTGRESQLCOLUMN_H
@@ -0,0 +1,133 @@
+#include "tst_kqpostgresqldatetime.h"
+#include "kqpostgresqldatetime.h"
+#include <QtTest>
+
+
+/**
+ * A date has a year of at least 4 digits.
+ */
+void TestKQPostgreSqlDateTime::parseDate()
+{
+    QDate date;
+    QVERIFY(KQPostgreSqlDateTime::parseDate("2017-03-21", date));
+    QCOMPARE(date, QDate(2017, 3, 21));
+    QVERIFY(KQPostgreSqlDateTime::parseDate("2024-02-29", date));
+    QCOMPARE(date, QDate(2024, 2, 29));
+    QVERIFY(KQPostgreSqlDateTime::parseDate("10000-01-01", date));
+    QCOMPARE(date, QDate(10000, 1, 1));
+}
+
+/**
+ * A BC date has a negative year. Qt has no year 0.
+ */
+void TestKQPostgreSqlDateTime::parseBcDate()
+{
+    QDate date;
+    QVERIFY(KQPostgreSqlDateTime::parseDate("1000-01-01 BC", date));
+    QCOMPARE(date, QDate(-1000, 1, 1));
+    QVERIFY(KQPostgreSqlDateTime::parseDate("0001-12-31 BC", date));
+    QCOMPARE(date, QDate(-1, 12, 31));
+}
+
+/**
+ * Text which is not a valid date in ISO format.
+ */
+void TestKQPostgreSqlDateTime::rejectDate()
+{
+    QDate date;
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("2017-3-21", date));
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("17-03-21", date));
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("2017-02-30", date));
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("2017-03-21x", date));
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("", date));
+}
+
+/**
+ * Qt keeps milliseconds. The offset of timetz is ignored.
+ */
+void TestKQPostgreSqlDateTime::parseTime()
+{
+    QTime time;
+    QVERIFY(KQPostgreSqlDateTime::parseTime("19:31:32", time));
+    QCOMPARE(time, QTime(19, 31, 32));
+    QVERIFY(KQPostgreSqlDateTime::parseTime("19:31:32.123456", time));
+    QCOMPARE(time, QTime(19, 31, 32, 123));
+    QVERIFY(KQPostgreSqlDateTime::parseTime("19:31:32+02", time));
+    QCOMPARE(time, QTime(19, 31, 32));
+    QVERIFY(! KQPostgreSqlDateTime::parseTime("19:31", time));
+    QVERIFY(! KQPostgreSqlDateTime::parseTime("24:00:01", time));
+}
+
+/**
+ * A timestamp without offset is local time.
+ */
+void TestKQPostgreSqlDateTime::parseDateTime()
+{
+    QDateTime dateTime;
+    QVERIFY(KQPostgreSqlDateTime::parseDateTime("2017-03-21 19:31:32.5", dateTime));
+    QCOMPARE(dateTime, QDateTime(QDate(2017, 3, 21), QTime(19, 31, 32, 500)));
+    QVERIFY(! KQPostgreSqlDateTime::parseDateTime("2017-03-21T19:31:32", dateTime));
+    QVERIFY(! KQPostgreSqlDateTime::parseDateTime("2017-03-21", dateTime));
+}
+
+/**
+ * The offset of timestamptz is kept. It can have minutes and seconds.
+ */
+void TestKQPostgreSqlDateTime::parseDateTimeWithOffset()
+{
+    QDateTime dateTime;
+    QVERIFY(KQPostgreSqlDateTime::parseDateTime("2017-03-21 19:31:32.5+05:30", dateTime));
+    QCOMPARE(dateTime, QDateTime(QDate(2017, 3, 21), QTime(19, 31, 32, 500), Qt::OffsetFromUTC, 19800));
+    QVERIFY(KQPostgreSqlDateTime::parseDateTime("1999-12-31 23:59:59-08", dateTime));
+    QCOMPARE(dateTime.offsetFromUtc(), -28800);
+    QVERIFY(KQPostgreSqlDateTime::parseDateTime("1900-01-01 00:00:00+01:02:03", dateTime));
+    QCOMPARE(dateTime.offsetFromUtc(), 3723);
+}
+
+/**
+ * Days since 1970-01-01 of the proleptic gregorian calendar.
+ */
+void TestKQPostgreSqlDateTime::parseDays()
+{
+    qint32 days = -1;
+    QVERIFY(KQPostgreSqlDateTime::parseDays("1970-01-01", days));
+    QCOMPARE(days, 0);
+    QVERIFY(KQPostgreSqlDateTime::parseDays("2000-03-01", days));
+    QCOMPARE(days, 11017);
+    QVERIFY(KQPostgreSqlDateTime::parseDays("1969-12-31", days));
+    QCOMPARE(days, -1);
+    QVERIFY(KQPostgreSqlDateTime::parseDays("0001-01-01 BC", days));
+    QCOMPARE(days, -719528);
+}
+
+/**
+ * Microseconds since 1970-01-01 00:00:00 UTC.
+ */
+void TestKQPostgreSqlDateTime::parseMicroseconds()
+{
+    qint64 microseconds = -1;
+    QVERIFY(KQPostgreSqlDateTime::parseMicroseconds("1970-01-01 00:00:00.000001", microseconds));
+    QCOMPARE(microseconds, Q_INT64_C(1));
+    QVERIFY(KQPostgreSqlDateTime::parseMicroseconds("1970-01-01 01:00:00+01", microseconds));
+    QCOMPARE(microseconds, Q_INT64_C(0));
+    QVERIFY(KQPostgreSqlDateTime::parseMicroseconds("1969-12-31 23:59:59", microseconds));
+    QCOMPARE(microseconds, Q_INT64_C(-1000000));
+    QVERIFY(KQPostgreSqlDateTime::parseMicroseconds("2017-03-21 19:31:32.123456+00", microseconds));
+    QCOMPARE(microseconds, Q_INT64_C(1490124692123456));
+}
+
+/**
+ * Special values are not parsed. The caller falls back.
+ */
+void TestKQPostgreSqlDateTime::rejectSpecialValues()
+{
+    QDate date;
+    QDateTime dateTime;
+    qint32 days = 0;
+    qint64 microseconds = 0;
+    QVERIFY(! KQPostgreSqlDateTime::parseDate("infinity", date));
+    QVERIFY(! KQPostgreSqlDateTime::parseDateTime("-infinity", dateTime));
+    QVERIFY(! KQPostgreSqlDateTime::parseDays("infinity", days));
+    QVERIFY(! KQPostgreSqlDateTime::parseMicroseconds("-infinity", microseconds));
+    QVERIFY(! KQPostgreSqlDateTime::parseMicroseconds("epoch", microseconds));
+}
@@ -0,0 +1,31 @@
+#ifndef TST_KQPOSTGRESQLDATETIME_H
+#define TST_KQPOSTGRESQLDATETIME_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlDateTime
+ * -------------------------------------------------------------------------------------
+ * Tests of KQPostgreSqlDateTime. Parses values in the ISO output format of
+ * PostgreSql.
+ */
+
+#include <QObject>
+
+
+class TestKQPostgreSqlDateTime : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseDate();
+    void parseBcDate();
+    void rejectDate();
+    void parseTime();
+    void parseDateTime();
+    void parseDateTimeWithOffset();
+    void parseDays();
+    void parseMicroseconds();
+    void rejectSpecialValues();
+};
+
+#endif // TST_KQPOSTGRESQLDATETIME_H
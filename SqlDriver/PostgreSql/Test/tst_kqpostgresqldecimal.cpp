@@ -0,0 +1,120 @@
+#include "tst_kqpostgresqldecimal.h"
+#include "kqpostgresqldecimal.h"
+#include <QtTest>
+
+
+/**
+ * Integers have scale 0. A sign is optional.
+ */
+void TestKQPostgreSqlDecimal::parseInteger()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(KQPostgreSqlDecimal::parse("42", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(42));
+    QCOMPARE(decimal.scale(), 0);
+    QVERIFY(KQPostgreSqlDecimal::parse("-42", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(-42));
+    QVERIFY(KQPostgreSqlDecimal::parse("+7", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(7));
+    QVERIFY(KQPostgreSqlDecimal::parse("0", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(0));
+}
+
+/**
+ * The scale is the number of digits after the point. Trailing
+ * zeros are kept.
+ */
+void TestKQPostgreSqlDecimal::parseFraction()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(KQPostgreSqlDecimal::parse("-1234.50", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(-123450));
+    QCOMPARE(decimal.scale(), 2);
+    QVERIFY(KQPostgreSqlDecimal::parse("0.000001", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(1));
+    QCOMPARE(decimal.scale(), 6);
+}
+
+/**
+ * Leading zeros do not count as significant digits.
+ */
+void TestKQPostgreSqlDecimal::parseLeadingZeros()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(KQPostgreSqlDecimal::parse("000123.4500", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(1234500));
+    QCOMPARE(decimal.scale(), 4);
+    QVERIFY(KQPostgreSqlDecimal::parse("0.00000000000000000000123", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(123));
+    QCOMPARE(decimal.scale(), 23);
+}
+
+/**
+ * 18 significant digits fit into qint64.
+ */
+void TestKQPostgreSqlDecimal::parseMaximumDigits()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(KQPostgreSqlDecimal::parse("999999999999999999", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(999999999999999999));
+    QVERIFY(KQPostgreSqlDecimal::parse("-12345678901234.5678", decimal));
+    QCOMPARE(decimal.value(), Q_INT64_C(-123456789012345678));
+    QCOMPARE(decimal.scale(), 4);
+}
+
+/**
+ * More than 18 significant digits are refused.
+ */
+void TestKQPostgreSqlDecimal::rejectTooManyDigits()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(! KQPostgreSqlDecimal::parse("1234567890123456789", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse("1.234567890123456789", decimal));
+}
+
+/**
+ * NaN and text without digits are not numbers.
+ */
+void TestKQPostgreSqlDecimal::rejectNoNumber()
+{
+    KQPostgreSqlDecimal decimal;
+    QVERIFY(! KQPostgreSqlDecimal::parse("NaN", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse("", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse("-", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse(".", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse("1.2.3", decimal));
+    QVERIFY(! KQPostgreSqlDecimal::parse("12a", decimal));
+}
+
+/**
+ * The integer part is cut off toward zero.
+ */
+void TestKQPostgreSqlDecimal::toInt64()
+{
+    QCOMPARE(KQPostgreSqlDecimal(-123450, 2).toInt64(), Q_INT64_C(-1234));
+    QCOMPARE(KQPostgreSqlDecimal(199, 2).toInt64(), Q_INT64_C(1));
+    QCOMPARE(KQPostgreSqlDecimal(42, 0).toInt64(), Q_INT64_C(42));
+    QCOMPARE(KQPostgreSqlDecimal(123, 23).toInt64(), Q_INT64_C(0));
+}
+
+/**
+ * Conversion to double.
+ */
+void TestKQPostgreSqlDecimal::toDouble()
+{
+    QCOMPARE(KQPostgreSqlDecimal(-123450, 2).toDouble(), -1234.5);
+    QCOMPARE(KQPostgreSqlDecimal(5, 1).toDouble(), 0.5);
+    QCOMPARE(KQPostgreSqlDecimal(7, 0).toDouble(), 7.0);
+}
+
+/**
+ * The text has as many digits after the point as the scale.
+ */
+void TestKQPostgreSqlDecimal::toString()
+{
+    QCOMPARE(KQPostgreSqlDecimal(-123450, 2).toString(), QString("-1234.50"));
+    QCOMPARE(KQPostgreSqlDecimal(5, 2).toString(), QString("0.05"));
+    QCOMPARE(KQPostgreSqlDecimal(0, 2).toString(), QString("0.00"));
+    QCOMPARE(KQPostgreSqlDecimal(42, 0).toString(), QString("42"));
+    QCOMPARE(KQPostgreSqlDecimal(-1, 3).toString(), QString("-0.001"));
+}
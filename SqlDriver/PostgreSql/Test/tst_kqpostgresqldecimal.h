@@ -0,0 +1,30 @@
+#ifndef TST_KQPOSTGRESQLDECIMAL_H
+#define TST_KQPOSTGRESQLDECIMAL_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlDecimal
+ * -------------------------------------------------------------------------------------
+ * Tests of KQPostgreSqlDecimal. Parses numeric values as the server sends them.
+ */
+
+#include <QObject>
+
+
+class TestKQPostgreSqlDecimal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseInteger();
+    void parseFraction();
+    void parseLeadingZeros();
+    void parseMaximumDigits();
+    void rejectTooManyDigits();
+    void rejectNoNumber();
+    void toInt64();
+    void toDouble();
+    void toString();
+};
+
+#endif // TST_KQPOSTGRESQLDECIMAL_H
@@ -0,0 +1,160 @@
+#include "tst_kqpostgresqlrowprefetch.h"
+#include "kqpostgresqldriver.h"
+#include "kqpostgresqlsyntheticresult.h"
+#include <QtTest>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+
+// Rows of the test results. No multiple of the prefetch count. So
+// the last block is not full.
+static const int resultRows = 103;
+
+// Rows of a prefetch block.
+static const int blockRows = 7;
+
+/**
+ * A result shape with all decoded types and NULL values.
+ * @return      The shape.
+ */
+static KQPostgreSqlSyntheticResult testShape()
+{
+    KQPostgreSqlSyntheticResult shape(resultRows);
+    shape.addColumn(QString("i4"), 23);
+    shape.addColumn(QString("i8"), 20);
+    shape.addColumn(QString("f8"), 701);
+    shape.addColumn(QString("num"), 1700);
+    shape.addColumn(QString("txt"), 25);
+    shape.addColumn(QString("flag"), 16);
+    shape.addColumn(QString("day"), 1082);
+    shape.addColumn(QString("ts"), 1114);
+    shape.addColumn(QString("tstz"), 1184);
+    shape.addColumn(QString("bin"), 17);
+    shape.setNullRatio(0.2);
+
+    return shape;
+}
+
+/**
+ * Compares the values of the current rows of two queries.
+ * @param cached        The query with prefetch.
+ * @param uncached      The query without prefetch.
+ * @return              True if the rows are at the same position and
+ *                      all values are equal.
+ */
+static bool isSameRow(const QSqlQuery& cached, const QSqlQuery& uncached)
+{
+    if (cached.at() != uncached.at()) {
+        return false;
+    }
+    int fieldCount = uncached.record().count();
+    for (int field=0; field<fieldCount; ++field) {
+        QVariant cachedValue = cached.value(field);
+        QVariant uncachedValue = uncached.value(field);
+        if (cachedValue.isNull() != uncachedValue.isNull() || cachedValue.type() != uncachedValue.type()) {
+            return false;
+        }
+        if (! uncachedValue.isNull() && cachedValue != uncachedValue) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Rows are read with next() from the first to the last row.
+ */
+void TestKQPostgreSqlRowPrefetch::forwardFetch()
+{
+    KQPostgreSqlSyntheticResult shape = testShape();
+    KQPostgreSqlDriver cachedDriver;
+    cachedDriver.setRowPrefetch(blockRows);
+    KQPostgreSqlDriver uncachedDriver;
+    QSqlQuery cached = cachedDriver.createQuery(shape.create());
+    QSqlQuery uncached = uncachedDriver.createQuery(shape.create());
+    int rows = 0;
+    while (uncached.next()) {
+        QVERIFY(cached.next());
+        QVERIFY2(isSameRow(cached, uncached), qPrintable(QString("Row %1").arg(uncached.at())));
+        ++rows;
+    }
+    QVERIFY(! cached.next());
+    QCOMPARE(rows, resultRows);
+}
+
+/**
+ * Rows are read with previous() from the last to the first row.
+ */
+void TestKQPostgreSqlRowPrefetch::backwardFetch()
+{
+    KQPostgreSqlSyntheticResult shape = testShape();
+    KQPostgreSqlDriver cachedDriver;
+    cachedDriver.setRowPrefetch(blockRows);
+    KQPostgreSqlDriver uncachedDriver;
+    QSqlQuery cached = cachedDriver.createQuery(shape.create());
+    QSqlQuery uncached = uncachedDriver.createQuery(shape.create());
+    QVERIFY(uncached.last());
+    QVERIFY(cached.last());
+    int rows = 1;
+    QVERIFY(isSameRow(cached, uncached));
+    while (uncached.previous()) {
+        QVERIFY(cached.previous());
+        QVERIFY2(isSameRow(cached, uncached), qPrintable(QString("Row %1").arg(uncached.at())));
+        ++rows;
+    }
+    QVERIFY(! cached.previous());
+    QCOMPARE(rows, resultRows);
+}
+
+/**
+ * Rows are read with seek() in random order. Some seeks are relative
+ * to the current row.
+ */
+void TestKQPostgreSqlRowPrefetch::randomSeek()
+{
+    KQPostgreSqlSyntheticResult shape = testShape();
+    KQPostgreSqlDriver cachedDriver;
+    cachedDriver.setRowPrefetch(blockRows);
+    KQPostgreSqlDriver uncachedDriver;
+    QSqlQuery cached = cachedDriver.createQuery(shape.create());
+    QSqlQuery uncached = uncachedDriver.createQuery(shape.create());
+    quint32 state = 7;
+    for (int index=0; index<1000; ++index) {
+        state = state * 1664525u + 1013904223u;
+        int row = (int)((state >> 8) % resultRows);
+        if (row == uncached.at()) {
+            continue;
+        }
+        bool isRelative = (index % 4 == 3) && uncached.at() >= 0;
+        int offset = isRelative ? row - uncached.at() : row;
+        QVERIFY(uncached.seek(offset, isRelative));
+        QVERIFY(cached.seek(offset, isRelative));
+        QVERIFY2(isSameRow(cached, uncached), qPrintable(QString("Row %1").arg(row)));
+    }
+    QVERIFY(! cached.seek(resultRows));
+    QVERIFY(! cached.seek(-1));
+}
+
+/**
+ * A prefetch count larger than the result loads all rows at once.
+ */
+void TestKQPostgreSqlRowPrefetch::blockOfWholeResult()
+{
+    KQPostgreSqlSyntheticResult shape = testShape();
+    KQPostgreSqlDriver cachedDriver;
+    cachedDriver.setRowPrefetch(resultRows * 2);
+    KQPostgreSqlDriver uncachedDriver;
+    QSqlQuery cached = cachedDriver.createQuery(shape.create());
+    QSqlQuery uncached = uncachedDriver.createQuery(shape.create());
+    QVERIFY(uncached.seek(resultRows / 2));
+    QVERIFY(cached.seek(resultRows / 2));
+    QVERIFY(isSameRow(cached, uncached));
+    while (uncached.previous()) {
+        QVERIFY(cached.previous());
+        QVERIFY(isSameRow(cached, uncached));
+    }
+    QVERIFY(uncached.last());
+    QVERIFY(cached.last());
+    QVERIFY(isSameRow(cached, uncached));
+}
@@ -0,0 +1,27 @@
+#ifndef TST_KQPOSTGRESQLROWPREFETCH_H
+#define TST_KQPOSTGRESQLROWPREFETCH_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlRowPrefetch
+ * -------------------------------------------------------------------------------------
+ * Tests of the row prefetch of KQPostgreSqlResult. A query with prefetch and a
+ * query without prefetch read the same KQPostgreSqlSyntheticResult. The values
+ * of both queries must be equal in each position.
+ */
+
+#include <QObject>
+
+
+class TestKQPostgreSqlRowPrefetch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void forwardFetch();
+    void backwardFetch();
+    void randomSeek();
+    void blockOfWholeResult();
+};
+
+#endif // TST_KQPOSTGRESQLROWPREFETCH_H
@@ -0,0 +1,161 @@
+#include "tst_kqpostgresqlsyntheticresult.h"
+#include "kqpostgresqlsyntheticresult.h"
+#include "kqpostgresqldatetime.h"
+#include "kqpostgresqlbytea.h"
+#include <QtTest>
+
+
+/**
+ * The result has the rows and the columns of the shape. Names and
+ * types are taken as they were added. All values are in text format.
+ */
+void TestKQPostgreSqlSyntheticResult::createShape()
+{
+    KQPostgreSqlSyntheticResult shape(25);
+    shape.addColumn(QString("id"), 20);
+    shape.addColumn(QString("created"), 1184);
+    shape.addColumn(QString("name"), 25);
+    QCOMPARE(shape.rows(), 25);
+    QCOMPARE(shape.columns(), 3);
+    PGresult* pResult = shape.create();
+    QVERIFY(pResult != NULL);
+    QCOMPARE(PQresultStatus(pResult), PGRES_TUPLES_OK);
+    QCOMPARE(PQntuples(pResult), 25);
+    QCOMPARE(PQnfields(pResult), 3);
+    QCOMPARE(QString(PQfname(pResult, 0)), QString("id"));
+    QCOMPARE(QString(PQfname(pResult, 1)), QString("created"));
+    QCOMPARE(QString(PQfname(pResult, 2)), QString("name"));
+    QCOMPARE(PQftype(pResult, 0), (Oid)20);
+    QCOMPARE(PQftype(pResult, 1), (Oid)1184);
+    QCOMPARE(PQftype(pResult, 2), (Oid)25);
+    for (int column=0; column<3; ++column) {
+        QCOMPARE(PQfformat(pResult, column), 0);
+    }
+    PQclear(pResult);
+}
+
+/**
+ * A shape without rows gives a valid result without tuples.
+ */
+void TestKQPostgreSqlSyntheticResult::createEmpty()
+{
+    KQPostgreSqlSyntheticResult shape(0);
+    shape.addColumn(QString("id"), 23);
+    PGresult* pResult = shape.create();
+    QVERIFY(pResult != NULL);
+    QCOMPARE(PQresultStatus(pResult), PGRES_TUPLES_OK);
+    QCOMPARE(PQntuples(pResult), 0);
+    QCOMPARE(PQnfields(pResult), 1);
+    PQclear(pResult);
+}
+
+/**
+ * Values are in the text format of the server. They can be parsed
+ * as the type of their column.
+ */
+void TestKQPostgreSqlSyntheticResult::createValues()
+{
+    KQPostgreSqlSyntheticResult shape(100);
+    shape.addColumn(QString("i8"), 20);
+    shape.addColumn(QString("flag"), 16);
+    shape.addColumn(QString("day"), 1082);
+    shape.addColumn(QString("tstz"), 1184);
+    shape.addColumn(QString("bin"), 17);
+    PGresult* pResult = shape.create();
+    QVERIFY(pResult != NULL);
+    for (int row=0; row<PQntuples(pResult); ++row) {
+        bool ok = false;
+        QString(PQgetvalue(pResult, row, 0)).toLongLong(&ok);
+        QVERIFY(ok);
+        QByteArray flag(PQgetvalue(pResult, row, 1));
+        QVERIFY(flag == "t" || flag == "f");
+        QDate date;
+        QVERIFY(KQPostgreSqlDateTime::parseDate(PQgetvalue(pResult, row, 2), date));
+        QDateTime dateTime;
+        QVERIFY(KQPostgreSqlDateTime::parseDateTime(PQgetvalue(pResult, row, 3), dateTime));
+        QByteArray bytes = KQPostgreSqlBytea::decode(PQgetvalue(pResult, row, 4), PQgetlength(pResult, row, 4));
+        QCOMPARE(bytes.size(), 16);
+    }
+    PQclear(pResult);
+}
+
+/**
+ * The share of NULL values is close to the ratio. Each value is
+ * NULL by chance. So the share is not exact.
+ */
+void TestKQPostgreSqlSyntheticResult::nullRatio()
+{
+    const double ratios[] = { 0.1, 0.25, 0.5, 0.9 };
+    for (int index=0; index<4; ++index) {
+        KQPostgreSqlSyntheticResult shape(10000);
+        shape.addColumn(QString("i4"), 23);
+        shape.addColumn(QString("bin"), 17);
+        shape.setNullRatio(ratios[index]);
+        PGresult* pResult = shape.create();
+        QVERIFY(pResult != NULL);
+        int nulls = 0;
+        for (int row=0; row<PQntuples(pResult); ++row) {
+            for (int column=0; column<PQnfields(pResult); ++column) {
+                nulls += PQgetisnull(pResult, row, column);
+            }
+        }
+        double share = (double)nulls / (PQntuples(pResult) * PQnfields(pResult));
+        QVERIFY2(qAbs(share - ratios[index]) < 0.02, qPrintable(QString("Ratio %1 gives %2").arg(ratios[index]).arg(share)));
+        PQclear(pResult);
+    }
+}
+
+/**
+ * Without a ratio there is no NULL value. A ratio of 1.0 gives only
+ * NULL values.
+ */
+void TestKQPostgreSqlSyntheticResult::noNulls()
+{
+    KQPostgreSqlSyntheticResult shape(1000);
+    shape.addColumn(QString("i4"), 23);
+    PGresult* pResult = shape.create();
+    QVERIFY(pResult != NULL);
+    for (int row=0; row<PQntuples(pResult); ++row) {
+        QVERIFY(! PQgetisnull(pResult, row, 0));
+    }
+    PQclear(pResult);
+    shape.setNullRatio(1.0);
+    pResult = shape.create();
+    QVERIFY(pResult != NULL);
+    for (int row=0; row<PQntuples(pResult); ++row) {
+        QVERIFY(PQgetisnull(pResult, row, 0));
+    }
+    PQclear(pResult);
+}
+
+/**
+ * The same seed gives the same values. Another seed gives other
+ * values.
+ */
+void TestKQPostgreSqlSyntheticResult::sameSeed()
+{
+    KQPostgreSqlSyntheticResult shape(50);
+    shape.addColumn(QString("i4"), 23);
+    shape.addColumn(QString("txt"), 25);
+    shape.setNullRatio(0.2);
+    shape.setSeed(42);
+    PGresult* pFirst = shape.create();
+    PGresult* pSecond = shape.create();
+    shape.setSeed(43);
+    PGresult* pOther = shape.create();
+    QVERIFY(pFirst != NULL && pSecond != NULL && pOther != NULL);
+    bool isOther = false;
+    for (int row=0; row<50; ++row) {
+        for (int column=0; column<2; ++column) {
+            QCOMPARE(PQgetisnull(pFirst, row, column), PQgetisnull(pSecond, row, column));
+            QCOMPARE(QByteArray(PQgetvalue(pFirst, row, column)), QByteArray(PQgetvalue(pSecond, row, column)));
+            if (QByteArray(PQgetvalue(pFirst, row, column)) != QByteArray(PQgetvalue(pOther, row, column))) {
+                isOther = true;
+            }
+        }
+    }
+    QVERIFY(isOther);
+    PQclear(pFirst);
+    PQclear(pSecond);
+    PQclear(pOther);
+}
@@ -0,0 +1,28 @@
+#ifndef TST_KQPOSTGRESQLSYNTHETICRESULT_H
+#define TST_KQPOSTGRESQLSYNTHETICRESULT_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestKQPostgreSqlSyntheticResult
+ * -------------------------------------------------------------------------------------
+ * Tests of KQPostgreSqlSyntheticResult. Checks the shape, the values and the
+ * ratio of NULL values of the generated results.
+ */
+
+#include <QObject>
+
+
+class TestKQPostgreSqlSyntheticResult : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createShape();
+    void createEmpty();
+    void createValues();
+    void nullRatio();
+    void noNulls();
+    void sameSeed();
+};
+
+#endif // TST_KQPOSTGRESQLSYNTHETICRESULT_H
@@ -0,0 +1,74 @@
+#include "kqpostgresqlbytea.h"
+
+
+/**
+ * A table with the value of each hex digit. All other characters
+ * are -1.
+ */
+class HexDigitTable
+{
+public:
+    HexDigitTable()
+    {
+        for (int index=0; index<256; ++index) {
+            m_values[index] = -1;
+        }
+        for (int digit=0; digit<10; ++digit) {
+            m_values['0' + digit] = (signed char)digit;
+        }
+        for (int digit=0; digit<6; ++digit) {
+            m_values['a' + digit] = (signed char)(10 + digit);
+            m_values['A' + digit] = (signed char)(10 + digit);
+        }
+    }
+
+    int value(const char symbol) const              { return m_values[(unsigned char)symbol]; }
+
+private:
+    signed char m_values[256];
+};
+
+static const HexDigitTable hexDigitTable;
+
+
+/**
+ * Decodes a bytea value.
+ * @param text          The bytea value in text format.
+ * @param length        The length of the text.
+ * @return              The bytes of the value.
+ */
+QByteArray KQPostgreSqlBytea::decode(const char *text, const int length)
+{
+    if (length >= 2 && text[0] == '\\' && text[1] == 'x' && (length % 2) == 0) {
+        QByteArray bytes((length - 2) / 2, Qt::Uninitialized);
+        if (decodeHex(text + 2, bytes.size(), bytes.data())) {
+            return bytes;
+        }
+    }
+    size_t byteCount = 0;
+    unsigned char* buffer = PQunescapeBytea((const unsigned char*)text, &byteCount);
+    QByteArray bytes((const char*)buffer, (int)byteCount);
+    PQfreemem(buffer);
+
+    return bytes;
+}
+
+/**
+ * Decodes hex digits. Two digits give one byte.
+ * @param text          The hex digits without the leading '\x'.
+ * @param length        The number of bytes to decode.
+ * @param buffer        A buffer for length bytes.
+ * @return              False if text has a character which is no hex digit.
+ */
+bool KQPostgreSqlBytea::decodeHex(const char *text, const int length, char *buffer)
+{
+    int invalid = 0;
+    for (int index=0; index<length; ++index) {
+        int high = hexDigitTable.value(text[2 * index]);
+        int low = hexDigitTable.value(text[2 * index + 1]);
+        invalid |= high | low;
+        buffer[index] = (char)(((unsigned int)high << 4) | (unsigned int)low);
+    }
+
+    return invalid >= 0;
+}
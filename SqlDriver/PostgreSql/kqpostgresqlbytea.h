@@ -0,0 +1,25 @@
+#ifndef KQPOSTGRESQLBYTEA_H
+#define KQPOSTGRESQLBYTEA_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlBytea
+ * -------------------------------------------------------------------------------------
+ * Decodes bytea values from the PostgreSql text format. The hex format
+ * ('\x0123abcd', default since PostgreSql 9.0) is decoded directly into the
+ * storage of a QByteArray. The loop has no branch per byte. The old escape
+ * format is decoded by PQunescapeBytea().
+ */
+
+#include <libpq-fe.h>
+#include <QByteArray>
+
+
+class KQPostgreSqlBytea
+{
+public:
+    static QByteArray decode(const char* text, const int length);
+    static bool decodeHex(const char* text, const int length, char* buffer);
+};
+
+#endif // KQPOSTGRESQLBYTEA_H
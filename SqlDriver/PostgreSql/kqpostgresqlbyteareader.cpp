@@ -0,0 +1,125 @@
+#include "kqpostgresqlbyteareader.h"
+#include "kqpostgresqlbytea.h"
+#include <cstring>
+
+
+/**
+ * Constructor
+ * @param pDriver       An open driver.
+ * @param tableName     The table with the bytea column.
+ * @param columnName    The bytea column.
+ * @param condition     A condition which selects exactly one row.
+ * @param parent        A parent object or NULL.
+ */
+KQPostgreSqlByteaReader::KQPostgreSqlByteaReader(KQPostgreSqlDriver *pDriver, const QString &tableName,
+                                                 const QString &columnName, const QString &condition, QObject *parent) :
+    QIODevice(parent),
+    m_pDriver(pDriver),
+    m_tableName(pDriver->escapeIdentifier(tableName, QSqlDriver::TableName)),
+    m_columnName(pDriver->escapeIdentifier(columnName, QSqlDriver::FieldName)),
+    m_condition(condition),
+    m_size(-1)
+{
+
+}
+
+/**
+ * Override
+ * Opens the reader. Reads the length of the value.
+ * @param mode      Must be ReadOnly.
+ * @return          True if the value was found.
+ */
+bool KQPostgreSqlByteaReader::open(QIODevice::OpenMode mode)
+{
+    if (mode & QIODevice::WriteOnly) {
+        setErrorString(QString("Bytea reader can not write !"));
+        return false;
+    }
+    PGconn* pConnection = connection();
+    if (pConnection == NULL) {
+        return false;
+    }
+    QString stmt = QString("SELECT octet_length(%1) FROM %2 WHERE %3").arg(m_columnName).arg(m_tableName).arg(m_condition);
+    PGresult* result = PQexec(pConnection, stmt.toLocal8Bit().data());
+    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) != 1) {
+        setErrorString(QString("Could not find bytea value !"));
+        PQclear(result);
+        return false;
+    }
+    m_size = QString(PQgetvalue(result, 0, 0)).toLongLong();
+    PQclear(result);
+
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Override
+ * Get the length of the value in bytes.
+ * @return      The length or -1 if reader is not open.
+ */
+qint64 KQPostgreSqlByteaReader::size() const
+{
+    return m_size;
+}
+
+/**
+ * Override
+ * Reads the next chunk of the value.
+ * @param data          A buffer for the data.
+ * @param maxSize       The size of the buffer.
+ * @return              The number of bytes read or -1 on error.
+ */
+qint64 KQPostgreSqlByteaReader::readData(char *data, qint64 maxSize)
+{
+    qint64 position = pos();
+    qint64 length = qMin(maxSize, m_size - position);
+    if (length <= 0) {
+        return 0;
+    }
+    PGconn* pConnection = connection();
+    if (pConnection == NULL) {
+        return -1;
+    }
+    QString stmt = QString("SELECT substring(%1 from %2 for %3) FROM %4 WHERE %5").arg(m_columnName)
+            .arg(position + 1).arg(length).arg(m_tableName).arg(m_condition);
+    PGresult* result = PQexec(pConnection, stmt.toLocal8Bit().data());
+    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) != 1) {
+        setErrorString(QString(PQresultErrorMessage(result)));
+        PQclear(result);
+        return -1;
+    }
+    QByteArray bytes = KQPostgreSqlBytea::decode(PQgetvalue(result, 0, 0), PQgetlength(result, 0, 0));
+    PQclear(result);
+    qint64 bytesRead = qMin((qint64)bytes.size(), length);
+    memcpy(data, bytes.constData(), bytesRead);
+
+    return bytesRead;
+}
+
+/**
+ * Private
+ * Get the current connection of the driver.
+ * @return      The connection or NULL if the driver is closed or deleted.
+ */
+PGconn *KQPostgreSqlByteaReader::connection()
+{
+    if (m_pDriver.isNull() || ! m_pDriver->isOpen()) {
+        setErrorString(QString("Driver is not open !"));
+        return NULL;
+    }
+
+    return m_pDriver->connection();
+}
+
+/**
+ * Override
+ * The reader can not write.
+ * @return      Always -1.
+ */
+qint64 KQPostgreSqlByteaReader::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+
+    return -1;
+}
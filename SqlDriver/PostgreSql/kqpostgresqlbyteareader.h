@@ -0,0 +1,52 @@
+#ifndef KQPOSTGRESQLBYTEAREADER_H
+#define KQPOSTGRESQLBYTEAREADER_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlByteaReader
+ * -------------------------------------------------------------------------------------
+ * Reads a bytea value in chunks. Each read() fetches one chunk of the value with
+ * 'substring(column from offset for length)'. The whole value is never held in
+ * memory. The row is selected by a condition like "id = 42".
+ * Table and column name are quoted identifiers. The condition is inserted
+ * as SQL text. It must not contain unchecked input.
+ * Each read takes the current connection of the driver. The reader goes on
+ * after a failover of the driver.
+ * The server reads only the requested part of a value if the column is stored
+ * uncompressed (ALTER TABLE ... SET STORAGE EXTERNAL). Otherwise each chunk
+ * decompresses the value up to the chunk.
+ */
+
+#include "kqpostgresqldriver.h"
+#include <QIODevice>
+#include <QPointer>
+
+
+class KQPostgreSqlByteaReader : public QIODevice
+{
+public:
+    KQPostgreSqlByteaReader(KQPostgreSqlDriver* pDriver, const QString& tableName, const QString& columnName,
+                            const QString& condition, QObject* parent = NULL);
+
+    // QIODevice interface
+public:
+    bool open(OpenMode mode) override;
+    bool isSequential() const override                  { return false; }
+    qint64 size() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    PGconn* connection();
+
+private:
+    QPointer<KQPostgreSqlDriver> m_pDriver;
+    QString m_tableName;
+    QString m_columnName;
+    QString m_condition;
+    qint64 m_size;
+};
+
+#endif // KQPOSTGRESQLBYTEAREADER_H
@@ -0,0 +1,303 @@
+#include "kqpostgresqlcolumn.h"
+#include "kqpostgresqldatetime.h"
+#include "kqpostgresqlbytea.h"
+#include <limits>
+
+
+/**
+ * Constructs an empty column.
+ */
+KQPostgreSqlColumn::KQPostgreSqlColumn() :
+    m_type(Utf8),
+    m_length(0),
+    m_nullCount(0)
+{
+
+}
+
+/**
+ * Decodes one field of a result into a column.
+ * @param pResult       A result with status PGRES_TUPLES_OK.
+ * @param field         The field number of the column.
+ * @param column        Takes all rows of the field.
+ * @return              False if the values do not fit into a column.
+ */
+bool KQPostgreSqlColumn::fromResult(const PGresult *pResult, const int field, KQPostgreSqlColumn &column)
+{
+    column = KQPostgreSqlColumn();
+    column.m_name = QString(PQfname(pResult, field));
+    column.m_type = typeFromPostgreType(PQftype(pResult, field));
+    column.m_length = PQntuples(pResult);
+    column.m_validity.fill(0, (column.m_length + 7) / 8);
+    for (int row=0; row<column.m_length; ++row) {
+        if (PQgetisnull(pResult, row, field)) {
+            ++column.m_nullCount;
+        } else {
+            setBit(column.m_validity, row);
+        }
+    }
+    if (column.m_type == Utf8 || column.m_type == Binary) {
+        return column.decodeVariableWidth(pResult, field);
+    }
+    column.decodeFixedWidth(pResult, field);
+
+    return true;
+}
+
+/**
+ * Lookup if a value of the column is NULL.
+ * @param row       The row number.
+ * @return          True if value is NULL.
+ */
+bool KQPostgreSqlColumn::isNull(const int row) const
+{
+    return (m_validity.at(row / 8) & (1 << (row % 8))) == 0;
+}
+
+/**
+ * Private
+ * Get the column type from a PostgreSql data type. Types without
+ * a fixed width representation are kept as Utf8 text.
+ * @param type      A PostgreSql Oid with data type information.
+ * @return          The column type.
+ */
+KQPostgreSqlColumn::Type KQPostgreSqlColumn::typeFromPostgreType(const Oid type)
+{
+    switch (type) {
+    case 16:        // bool
+        return Boolean;
+        break;
+    case 21:        // int2
+        return Int16;
+        break;
+    case 23:        // int4
+        return Int32;
+        break;
+    case 20:        // int8
+        return Int64;
+        break;
+    case 700:       // float4
+        return Float32;
+        break;
+    case 701:       // float8
+        return Float64;
+        break;
+    case 1082:      // date
+        return Date32;
+        break;
+    case 1114:      // timestamp
+    case 1184:      // timestamptz
+        return TimestampMicro;
+        break;
+    case 17:        // bytea
+        return Binary;
+        break;
+    default:
+        break;
+    }
+
+    return Utf8;
+}
+
+/**
+ * Private
+ * Decodes the text values of a fixed width column into the values buffer.
+ * A date or timestamp which can not be represented is set to NULL.
+ * @param pResult       The result.
+ * @param field         The field number of the column.
+ */
+void KQPostgreSqlColumn::decodeFixedWidth(const PGresult *pResult, const int field)
+{
+    switch (m_type) {
+    case Boolean:
+        m_values.fill(0, (m_length + 7) / 8);
+        break;
+    case Int16:
+        m_values.fill(0, m_length * sizeof(qint16));
+        break;
+    case Int32:
+    case Float32:
+    case Date32:
+        m_values.fill(0, m_length * sizeof(qint32));
+        break;
+    default:
+        m_values.fill(0, m_length * sizeof(qint64));
+        break;
+    }
+    char* buffer = m_values.data();
+    for (int row=0; row<m_length; ++row) {
+        if (PQgetisnull(pResult, row, field)) {
+            continue;
+        }
+        const char* value = PQgetvalue(pResult, row, field);
+        switch (m_type) {
+        case Boolean:
+            if (value[0] == 't') {
+                setBit(m_values, row);
+            }
+            break;
+        case Int16:
+            reinterpret_cast<qint16*>(buffer)[row] = (qint16)parseInteger(value);
+            break;
+        case Int32:
+            reinterpret_cast<qint32*>(buffer)[row] = (qint32)parseInteger(value);
+            break;
+        case Int64:
+            reinterpret_cast<qint64*>(buffer)[row] = parseInteger(value);
+            break;
+        case Float32:
+            reinterpret_cast<float*>(buffer)[row] = QByteArray::fromRawData(value, PQgetlength(pResult, row, field)).toFloat();
+            break;
+        case Float64:
+            reinterpret_cast<double*>(buffer)[row] = QByteArray::fromRawData(value, PQgetlength(pResult, row, field)).toDouble();
+            break;
+        case Date32:
+            if (! KQPostgreSqlDateTime::parseDays(value, reinterpret_cast<qint32*>(buffer)[row])) {
+                reinterpret_cast<qint32*>(buffer)[row] = 0;
+                setNull(row);
+            }
+            break;
+        case TimestampMicro:
+            if (! KQPostgreSqlDateTime::parseMicroseconds(value, reinterpret_cast<qint64*>(buffer)[row])) {
+                reinterpret_cast<qint64*>(buffer)[row] = 0;
+                setNull(row);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * Private
+ * Copies the values of a text or bytea column into the values buffer
+ * and builds the offsets.
+ * @param pResult       The result.
+ * @param field         The field number of the column.
+ * @return              False if the values exceed the int32 offsets.
+ */
+bool KQPostgreSqlColumn::decodeVariableWidth(const PGresult *pResult, const int field)
+{
+    m_offsets.resize((m_length + 1) * sizeof(qint32));
+    qint32* offsets = reinterpret_cast<qint32*>(m_offsets.data());
+    offsets[0] = 0;
+    for (int row=0; row<m_length; ++row) {
+        if (! PQgetisnull(pResult, row, field)) {
+            const char* value = PQgetvalue(pResult, row, field);
+            int length = PQgetlength(pResult, row, field);
+            if (m_type == Binary) {
+                if (! appendBytea(value, length)) {
+                    return false;
+                }
+            } else {
+                if (! hasRoomFor(length)) {
+                    return false;
+                }
+                m_values.append(value, length);
+            }
+        }
+        offsets[row + 1] = m_values.size();
+    }
+
+    return true;
+}
+
+/**
+ * Private
+ * Appends the bytes of a bytea value to the values buffer. Hex values
+ * are decoded directly into the buffer.
+ * @param value         The bytea value in text format.
+ * @param length        The length of the text.
+ * @return              False if the bytes exceed the int32 offsets.
+ */
+bool KQPostgreSqlColumn::appendBytea(const char *value, const int length)
+{
+    int size = m_values.size();
+    if (length >= 2 && value[0] == '\\' && value[1] == 'x' && (length % 2) == 0) {
+        int byteCount = (length - 2) / 2;
+        if (! hasRoomFor(byteCount)) {
+            return false;
+        }
+        m_values.resize(size + byteCount);
+        if (KQPostgreSqlBytea::decodeHex(value + 2, byteCount, m_values.data() + size)) {
+            return true;
+        }
+        m_values.resize(size);
+    }
+    QByteArray bytes = KQPostgreSqlBytea::decode(value, length);
+    if (! hasRoomFor(bytes.size())) {
+        return false;
+    }
+    m_values.append(bytes);
+
+    return true;
+}
+
+/**
+ * Private
+ * Tests if the values buffer can take more bytes. The offsets of
+ * the values are int32.
+ * @param byteCount     The number of bytes to append.
+ * @return              True if the offset of the last byte fits into int32.
+ */
+bool KQPostgreSqlColumn::hasRoomFor(const qint64 byteCount) const
+{
+    return m_values.size() + byteCount <= std::numeric_limits<qint32>::max();
+}
+
+/**
+ * Private
+ * Marks a value as NULL.
+ * @param row       The row number.
+ */
+void KQPostgreSqlColumn::setNull(const int row)
+{
+    clearBit(m_validity, row);
+    ++m_nullCount;
+}
+
+/**
+ * Private
+ * Parses a decimal integer in PostgreSql text format.
+ * @param value     A null terminated string.
+ * @return          The integer value.
+ */
+qint64 KQPostgreSqlColumn::parseInteger(const char *value)
+{
+    bool isNegative = (*value == '-');
+    if (isNegative) {
+        ++value;
+    }
+    quint64 number = 0;
+    while (*value >= '0' && *value <= '9') {
+        number = number * 10 + (*value - '0');
+        ++value;
+    }
+
+    return isNegative ? (qint64)(0 - number) : (qint64)number;
+}
+
+/**
+ * Private
+ * Set a bit in a bitmap. Least significant bit first.
+ * @param bitmap    The bitmap.
+ * @param index     The number of the bit.
+ */
+void KQPostgreSqlColumn::setBit(QByteArray &bitmap, const int index)
+{
+    char* bytes = bitmap.data();
+    bytes[index / 8] |= (char)(1 << (index % 8));
+}
+
+/**
+ * Private
+ * Clear a bit in a bitmap. Least significant bit first.
+ * @param bitmap    The bitmap.
+ * @param index     The number of the bit.
+ */
+void KQPostgreSqlColumn::clearBit(QByteArray &bitmap, const int index)
+{
+    char* bytes = bitmap.data();
+    bytes[index / 8] &= (char)~(1 << (index % 8));
+}
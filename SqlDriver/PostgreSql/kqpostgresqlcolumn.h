@@ -0,0 +1,75 @@
+#ifndef KQPOSTGRESQLCOLUMN_H
+#define KQPOSTGRESQLCOLUMN_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlColumn
+ * -------------------------------------------------------------------------------------
+ * One column of a query result in a columnar memory layout. The values are
+ * decoded directly from the PGresult into contiguous buffers. No QVariant is
+ * created. The buffers follow the Apache Arrow memory format:
+ *
+ * validity     One bit per row. Least significant bit first. A set bit is a
+ *              value and a cleared bit is NULL.
+ * values       Fixed width types keep length() values of the type width.
+ *              Boolean values are packed as bits like the validity buffer.
+ *              Utf8 and Binary keep the bytes of all values one after another.
+ *              Date32 is days since 1970-01-01. TimestampMicro is microseconds
+ *              since 1970-01-01 00:00:00. Values of timestamptz are UTC.
+ * offsets      Only for Utf8 and Binary. length() + 1 int32 offsets into
+ *              the values buffer. Value i is from offsets[i] to offsets[i+1].
+ *
+ * The buffers can be handed to Arrow without conversion. The value of a
+ * NULL is zero or empty. Dates and timestamps without a representation,
+ * like 'infinity' or BC dates, are NULL as well.
+ * A Utf8 or Binary column can not hold more than 2 GB because of the int32
+ * offsets. A larger result can not be decoded into a column.
+ */
+
+#include <libpq-fe.h>
+#include <QByteArray>
+#include <QString>
+
+
+class KQPostgreSqlColumn
+{
+public:
+    enum Type { Boolean, Int16, Int32, Int64, Float32, Float64, Date32, TimestampMicro, Utf8, Binary };
+
+    KQPostgreSqlColumn();
+
+    static bool fromResult(const PGresult* pResult, const int field, KQPostgreSqlColumn& column);
+
+    QString name() const                                { return m_name; }
+    Type type() const                                   { return m_type; }
+    int length() const                                  { return m_length; }
+    int nullCount() const                               { return m_nullCount; }
+    bool isNull(const int row) const;
+    const QByteArray& validity() const                  { return m_validity; }
+    const QByteArray& offsets() const                   { return m_offsets; }
+    const QByteArray& values() const                    { return m_values; }
+    template<class V>
+    const V* data() const                               { return reinterpret_cast<const V*>(m_values.constData()); }
+
+private:
+    static Type typeFromPostgreType(const Oid type);
+    void decodeFixedWidth(const PGresult* pResult, const int field);
+    bool decodeVariableWidth(const PGresult* pResult, const int field);
+    bool appendBytea(const char* value, const int length);
+    bool hasRoomFor(const qint64 byteCount) const;
+    void setNull(const int row);
+    static qint64 parseInteger(const char* value);
+    static void setBit(QByteArray& bitmap, const int index);
+    static void clearBit(QByteArray& bitmap, const int index);
+
+private:
+    QString m_name;
+    Type m_type;
+    int m_length;
+    int m_nullCount;
+    QByteArray m_validity;
+    QByteArray m_offsets;
+    QByteArray m_values;
+};
+
+#endif // KQPOSTGRESQLCOLUMN_H
@@ -0,0 +1,234 @@
+#include "kqpostgresqldatetime.h"
+
+
+/**
+ * Parses a date value.
+ * @param text      A null terminated date string.
+ * @param date      Is set to the parsed date.
+ * @return          True if text is a valid date.
+ */
+bool KQPostgreSqlDateTime::parseDate(const char *text, QDate &date)
+{
+    Fields fields;
+    if (! parseFields(text, fields, true, false)) {
+        return false;
+    }
+    date = QDate(fields.year, fields.month, fields.day);
+
+    return date.isValid();
+}
+
+/**
+ * Parses a time value. The offset of a timetz value is ignored.
+ * Qt keeps milliseconds. Further digits are cut off.
+ * @param text      A null terminated time string.
+ * @param time      Is set to the parsed time.
+ * @return          True if text is a valid time.
+ */
+bool KQPostgreSqlDateTime::parseTime(const char *text, QTime &time)
+{
+    Fields fields;
+    if (! parseFields(text, fields, false, true)) {
+        return false;
+    }
+    time = QTime(fields.hour, fields.minute, fields.second, fields.microsecond / 1000);
+
+    return time.isValid();
+}
+
+/**
+ * Parses a timestamp value. A timestamp with offset gives a QDateTime
+ * with this offset from UTC. A timestamp without offset is local time.
+ * @param text          A null terminated timestamp string.
+ * @param dateTime      Is set to the parsed timestamp.
+ * @return              True if text is a valid timestamp.
+ */
+bool KQPostgreSqlDateTime::parseDateTime(const char *text, QDateTime &dateTime)
+{
+    Fields fields;
+    if (! parseFields(text, fields, true, true)) {
+        return false;
+    }
+    QDate date(fields.year, fields.month, fields.day);
+    QTime time(fields.hour, fields.minute, fields.second, fields.microsecond / 1000);
+    if (! date.isValid() || ! time.isValid()) {
+        return false;
+    }
+    if (fields.hasOffset) {
+        dateTime = QDateTime(date, time, Qt::OffsetFromUTC, fields.offset);
+    } else {
+        dateTime = QDateTime(date, time);
+    }
+
+    return true;
+}
+
+/**
+ * Parses a date value into days since 1970-01-01.
+ * @param text      A null terminated date string.
+ * @param days      Is set to the number of days.
+ * @return          True if text is a date.
+ */
+bool KQPostgreSqlDateTime::parseDays(const char *text, qint32 &days)
+{
+    Fields fields;
+    if (! parseFields(text, fields, true, false)) {
+        return false;
+    }
+    days = (qint32)daysFromCivil(fields.year, fields.month, fields.day);
+
+    return true;
+}
+
+/**
+ * Parses a timestamp value into microseconds since 1970-01-01 00:00:00.
+ * A timestamp with offset is converted to UTC.
+ * @param text              A null terminated timestamp string.
+ * @param microseconds      Is set to the number of microseconds.
+ * @return                  True if text is a timestamp.
+ */
+bool KQPostgreSqlDateTime::parseMicroseconds(const char *text, qint64 &microseconds)
+{
+    Fields fields;
+    if (! parseFields(text, fields, true, true)) {
+        return false;
+    }
+    qint64 seconds = daysFromCivil(fields.year, fields.month, fields.day) * 86400
+            + fields.hour * 3600 + fields.minute * 60 + fields.second - fields.offset;
+    microseconds = seconds * 1000000 + fields.microsecond;
+
+    return true;
+}
+
+/**
+ * Private
+ * Reads the fields of a date, a time or a timestamp.
+ * The year of a BC date is set as Qt counts it: 1 BC is year -1.
+ * @param text          A null terminated string.
+ * @param fields        Is set to the values of the fields.
+ * @param hasDate       True if text starts with a date.
+ * @param hasTime       True if text has a time.
+ * @return              True if the whole text was read.
+ */
+bool KQPostgreSqlDateTime::parseFields(const char *text, Fields &fields, const bool hasDate, const bool hasTime)
+{
+    fields.year = 2000;
+    fields.month = 1;
+    fields.day = 1;
+    fields.hour = 0;
+    fields.minute = 0;
+    fields.second = 0;
+    fields.microsecond = 0;
+    fields.offset = 0;
+    fields.hasOffset = false;
+    if (hasDate) {
+        // The year has at least 4 digits.
+        int yearDigits = 0;
+        while (text[yearDigits] >= '0' && text[yearDigits] <= '9') {
+            ++yearDigits;
+        }
+        if (yearDigits < 4 || yearDigits > 7 || ! readNumber(text, yearDigits, fields.year)) {
+            return false;
+        }
+        if (*text++ != '-' || ! readNumber(text, 2, fields.month) || *text++ != '-' || ! readNumber(text, 2, fields.day)) {
+            return false;
+        }
+        if (hasTime && *text++ != ' ') {
+            return false;
+        }
+    }
+    if (hasTime) {
+        if (! readNumber(text, 2, fields.hour) || *text++ != ':' || ! readNumber(text, 2, fields.minute)
+                || *text++ != ':' || ! readNumber(text, 2, fields.second)) {
+            return false;
+        }
+        if (*text == '.') {
+            ++text;
+            int scale = 100000;
+            while (*text >= '0' && *text <= '9') {
+                fields.microsecond += (*text - '0') * scale;
+                scale /= 10;
+                ++text;
+            }
+        }
+        if (*text == '+' || *text == '-') {
+            int sign = (*text == '-') ? -1 : 1;
+            int hours = 0;
+            int minutes = 0;
+            int seconds = 0;
+            ++text;
+            if (! readNumber(text, 2, hours)) {
+                return false;
+            }
+            if (*text == ':') {
+                ++text;
+                if (! readNumber(text, 2, minutes)) {
+                    return false;
+                }
+            }
+            if (*text == ':') {
+                ++text;
+                if (! readNumber(text, 2, seconds)) {
+                    return false;
+                }
+            }
+            fields.offset = sign * (hours * 3600 + minutes * 60 + seconds);
+            fields.hasOffset = true;
+        }
+    }
+    if (hasDate && text[0] == ' ' && text[1] == 'B' && text[2] == 'C') {
+        fields.year = -fields.year;
+        text += 3;
+    }
+
+    return *text == '\0';
+}
+
+/**
+ * Private
+ * Reads a number with a fixed count of digits. The text pointer is
+ * moved behind the number.
+ * @param text          The text position.
+ * @param digits        The number of digits.
+ * @param value         Is set to the number.
+ * @return              False if one of the characters is not a digit.
+ */
+bool KQPostgreSqlDateTime::readNumber(const char *&text, const int digits, int &value)
+{
+    int number = 0;
+    for (int index=0; index<digits; ++index) {
+        unsigned int digit = (unsigned int)(text[index] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        number = number * 10 + (int)digit;
+    }
+    value = number;
+    text += digits;
+
+    return true;
+}
+
+/**
+ * Private
+ * Counts the days from 1970-01-01 to a date of the proleptic gregorian
+ * calendar.
+ * @param year      The year. Negative for BC as Qt counts it.
+ * @param month     The month 1 to 12.
+ * @param day       The day of month.
+ * @return          Days since 1970-01-01. Negative before.
+ */
+qint64 KQPostgreSqlDateTime::daysFromCivil(int year, const int month, const int day)
+{
+    // Qt has no year 0. Astronomical year numbering has: 1 BC is year 0.
+    if (year < 0) {
+        ++year;
+    }
+    qint64 y = (month <= 2) ? year - 1 : year;
+    qint64 era = (y >= 0 ? y : y - 399) / 400;
+    qint64 yearOfEra = y - era * 400;
+    qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return era * 146097 + dayOfEra - 719468;
+}
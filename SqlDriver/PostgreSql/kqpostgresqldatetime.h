@@ -0,0 +1,52 @@
+#ifndef KQPOSTGRESQLDATETIME_H
+#define KQPOSTGRESQLDATETIME_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlDateTime
+ * -------------------------------------------------------------------------------------
+ * Parses date, time and timestamp values in the ISO output format of PostgreSql
+ * (DateStyle ISO). The text is read in place. No QString is created.
+ *
+ *      date            2017-03-21          1000-01-01 BC
+ *      time            19:31:32.123456
+ *      timetz          19:31:32+02
+ *      timestamp       2017-03-21 19:31:32.5
+ *      timestamptz     2017-03-21 19:31:32.5+05:30
+ *
+ * The offset of timestamptz is kept. Special values like 'infinity' are not
+ * parsed. The parse functions return false for them and the caller can fall
+ * back to a general parser.
+ */
+
+#include <QDateTime>
+
+
+class KQPostgreSqlDateTime
+{
+public:
+    static bool parseDate(const char* text, QDate& date);
+    static bool parseTime(const char* text, QTime& time);
+    static bool parseDateTime(const char* text, QDateTime& dateTime);
+    static bool parseDays(const char* text, qint32& days);
+    static bool parseMicroseconds(const char* text, qint64& microseconds);
+
+private:
+    struct Fields {
+        int year;
+        int month;
+        int day;
+        int hour;
+        int minute;
+        int second;
+        int microsecond;
+        int offset;
+        bool hasOffset;
+    };
+
+    static bool parseFields(const char* text, Fields& fields, const bool hasDate, const bool hasTime);
+    static bool readNumber(const char*& text, const int digits, int& value);
+    static qint64 daysFromCivil(int year, const int month, const int day);
+};
+
+#endif // KQPOSTGRESQLDATETIME_H
@@ -0,0 +1,111 @@
+#include "kqpostgresqldecimal.h"
+
+
+// Powers of ten which fit into qint64.
+static const qint64 powerOfTen[19] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL,
+    10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL, 100000000000000LL,
+    1000000000000000LL, 10000000000000000LL, 100000000000000000LL, 1000000000000000000LL
+};
+
+
+/**
+ * Parses the text of a PostgreSql numeric value. The text has the form
+ * [-]digits[.digits] as it is sent by the server.
+ * @param text          A null terminated string.
+ * @param decimal       Is set to the parsed value.
+ * @return              False if text is not a number (NaN) or has more than 18 digits.
+ */
+bool KQPostgreSqlDecimal::parse(const char *text, KQPostgreSqlDecimal &decimal)
+{
+    bool isNegative = false;
+    if (*text == '-') {
+        isNegative = true;
+        ++text;
+    } else if (*text == '+') {
+        ++text;
+    }
+    quint64 value = 0;
+    int digits = 0;
+    int scale = 0;
+    bool hasPoint = false;
+    bool hasDigit = false;
+    for (; *text != '\0'; ++text) {
+        char symbol = *text;
+        if (symbol == '.' && ! hasPoint) {
+            hasPoint = true;
+            continue;
+        }
+        if (symbol < '0' || symbol > '9') {
+            return false;
+        }
+        hasDigit = true;
+        if (hasPoint) {
+            ++scale;
+        }
+        if (value == 0 && symbol == '0') {
+            continue;
+        }
+        if (++digits > 18) {
+            return false;
+        }
+        value = value * 10 + (symbol - '0');
+    }
+    if (! hasDigit) {
+        return false;
+    }
+    decimal.m_value = isNegative ? -(qint64)value : (qint64)value;
+    decimal.m_scale = scale;
+
+    return true;
+}
+
+/**
+ * Get the integer part of the number. Digits after the decimal point
+ * are cut off.
+ * @return      The integer part.
+ */
+qint64 KQPostgreSqlDecimal::toInt64() const
+{
+    if (m_scale > 18) {
+        return 0;
+    }
+
+    return m_value / powerOfTen[m_scale];
+}
+
+/**
+ * Get the number as double. Precision may be lost.
+ * @return      The number as double.
+ */
+double KQPostgreSqlDecimal::toDouble() const
+{
+    if (m_scale <= 18) {
+        return (double)m_value / (double)powerOfTen[m_scale];
+    }
+    double value = (double)m_value;
+    for (int index=0; index<m_scale; ++index) {
+        value /= 10.0;
+    }
+
+    return value;
+}
+
+/**
+ * Get the text representation of the number. It has as many digits
+ * after the decimal point as the scale.
+ * @return      The number as string.
+ */
+QString KQPostgreSqlDecimal::toString() const
+{
+    QString digits = QString::number(qAbs(m_value));
+    if (m_scale > 0) {
+        digits = digits.rightJustified(m_scale + 1, QChar('0'));
+        digits.insert(digits.length() - m_scale, QChar('.'));
+    }
+    if (m_value < 0) {
+        digits.prepend(QChar('-'));
+    }
+
+    return digits;
+}
@@ -0,0 +1,53 @@
+#ifndef KQPOSTGRESQLDECIMAL_H
+#define KQPOSTGRESQLDECIMAL_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlDecimal
+ * -------------------------------------------------------------------------------------
+ * A fixed point decimal number for PostgreSql numeric values. The number is an
+ * integer value and a scale. The decimal value is value / 10^scale.
+ *      '-1234.50'  ->  value = -123450, scale = 2
+ * The text of a numeric value is parsed without heap allocation and without a
+ * double in between. No precision is lost. Values with more than 18 significant
+ * digits do not fit and can not be parsed.
+ */
+
+#include <QtGlobal>
+#include <QMetaType>
+#include <QString>
+
+
+class KQPostgreSqlDecimal
+{
+public:
+    KQPostgreSqlDecimal() :
+        m_value(0),
+        m_scale(0)
+    {
+
+    }
+
+    KQPostgreSqlDecimal(const qint64 value, const int scale) :
+        m_value(value),
+        m_scale(scale)
+    {
+
+    }
+
+    static bool parse(const char* text, KQPostgreSqlDecimal& decimal);
+
+    qint64 value() const                                { return m_value; }
+    int scale() const                                   { return m_scale; }
+    qint64 toInt64() const;
+    double toDouble() const;
+    QString toString() const;
+
+private:
+    qint64 m_value;
+    int m_scale;
+};
+
+Q_DECLARE_METATYPE(KQPostgreSqlDecimal)
+
+#endif // KQPOSTGRESQLDECIMAL_H
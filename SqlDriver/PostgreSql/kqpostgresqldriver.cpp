@@ -2,17 +2,37 @@
 #include "kqpostgresqlresult.h"
 #include <QSqlQuery>
 #include <QSqlField>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QAtomicInteger>
 #include <QDebug>
+#include <sys/select.h>
+#include <cerrno>
+#include <cstring>
 
 Q_DECLARE_OPAQUE_POINTER(PGconn*)
 Q_DECLARE_METATYPE(PGconn*)
 
+// Bytes held by results of all drivers in the process.
+static QAtomicInteger<qint64> liveResultBytes(0);
+
 
 /**
  * Standard Constructor for the driver.
  */
 KQPostgreSqlDriver::KQPostgreSqlDriver() :
-    m_pConnection(NULL)
+    m_pConnection(NULL),
+    m_connectionSerial(0),
+    m_pStatistics(NULL),
+    m_slowQueryThreshold(0),
+    m_explainSampleRate(1),
+    m_slowQueryCount(0),
+    m_rowPrefetch(0),
+    m_resultSizeLimit(0),
+    m_resultBytes(0),
+    m_primaryIndex(0),
+    m_nextReplica(0),
+    m_readRouting(RoundRobin)
 {
     setOpen(false);
 }
@@ -22,10 +42,375 @@ KQPostgreSqlDriver::KQPostgreSqlDriver() :
  */
 KQPostgreSqlDriver::~KQPostgreSqlDriver()
 {
+    closePool();
+    closeReplicas();
     if (m_pConnection) {
         PQfinish(m_pConnection);
         m_pConnection = NULL;
     }
+    delete m_pStatistics;
+}
+
+/**
+ * Adds a host to the list of database hosts. Hosts are used by the
+ * next call to open().
+ * A Primary host is used as failover host when the connection to the
+ * current primary is lost. Replica hosts take read only statements
+ * which are executed outside of a transaction.
+ * Prepared statements are not routed. They are prepared and executed
+ * on the primary connection only.
+ * @param host          The host name or address.
+ * @param port          The port number of the database on this host.
+ * @param role          Primary or Replica.
+ */
+void KQPostgreSqlDriver::addHost(const QString &host, const int port, const HostRole role)
+{
+    Host entry = { host, port, role, NULL, -1 };
+    m_hosts.append(entry);
+}
+
+/**
+ * Removes all hosts which were added with addHost().
+ */
+void KQPostgreSqlDriver::clearHosts()
+{
+    m_hosts.clear();
+}
+
+/**
+ * Inserts or updates many rows with one statement. Each column is sent
+ * as one array parameter. The server unpacks the arrays with unnest():
+ *      INSERT INTO table (a, b) SELECT * FROM unnest($1::int[], $2::text[])
+ *      ON CONFLICT (a) DO UPDATE SET b = EXCLUDED.b RETURNING a
+ * Rows with a conflict update all columns which are not conflict columns.
+ * The rows must not have a conflict among each other.
+ * Table and column names are quoted. Each column must exist in the
+ * table. The statement runs on the primary connection like any other
+ * statement of a result. So statistics and the result size limit apply.
+ * @param tableName         The table to insert into.
+ * @param columns           The column names. Same order as the values of a row.
+ * @param rows              The rows to insert. Each row has a value for each column.
+ * @param conflictColumns   Columns of a unique index which detect a conflict.
+ * @param returning         Optional expression list for a RETURNING clause. Is not quoted.
+ * @return                  A query with the returned rows. Check lastError() of the query.
+ */
+QSqlQuery KQPostgreSqlDriver::upsert(const QString &tableName, const QStringList &columns,
+                                     const QVector<QVector<QVariant> > &rows, const QStringList &conflictColumns,
+                                     const QString &returning)
+{
+    KQPostgreSqlResult* result = new KQPostgreSqlResult(this);
+    QSqlQuery query(result);
+    if (! isOpen()) {
+        QSqlError error(QString("Upsert failed !"), QString("Connection is not open."), QSqlError::ConnectionError);
+        result->setLastError(error);
+        return query;
+    }
+    QString table = escapeIdentifier(tableName, QSqlDriver::TableName);
+    QHash<QString, QString> types = columnTypes(table);
+    QStringList names;
+    QStringList arrays;
+    QStringList updates;
+    QVector<QByteArray> parameters;
+    for (int column=0; column<columns.size(); ++column) {
+        QString columnName = stripDelimiters(columns.at(column), QSqlDriver::FieldName);
+        if (! types.contains(columnName)) {
+            QSqlError error(QString("Unknown column %1 !").arg(columnName),
+                            QString("Table %1 has no column %2.").arg(tableName).arg(columnName), QSqlError::StatementError);
+            result->setLastError(error);
+            return query;
+        }
+        QString name = escapeIdentifier(columnName, QSqlDriver::FieldName);
+        names << name;
+        arrays << QString("$%1::%2[]").arg(column + 1).arg(types.value(columnName));
+        if (! conflictColumns.contains(columns.at(column))) {
+            updates << QString("%1 = EXCLUDED.%1").arg(name);
+        }
+        parameters.append(arrayLiteral(rows, column).toUtf8());
+    }
+    QStringList conflictNames;
+    foreach (const QString& conflictColumn, conflictColumns) {
+        conflictNames << escapeIdentifier(conflictColumn, QSqlDriver::FieldName);
+    }
+    QString stmt = QString("INSERT INTO %1 (%2) SELECT * FROM unnest(%3)").arg(table).arg(names.join(QString(", ")))
+            .arg(arrays.join(QString(", ")));
+    if (! conflictNames.isEmpty()) {
+        stmt.append(QString(" ON CONFLICT (%1) DO ").arg(conflictNames.join(QString(", "))));
+        if (updates.isEmpty()) {
+            stmt.append(QString("NOTHING"));
+        } else {
+            stmt.append(QString("UPDATE SET ")).append(updates.join(QString(", ")));
+        }
+    }
+    if (! returning.isEmpty()) {
+        stmt.append(QString(" RETURNING ")).append(returning);
+    }
+    result->execParams(stmt, parameters);
+
+    return query;
+}
+
+/**
+ * Lets a query capture the id of inserted rows. The driver adds a
+ * RETURNING clause with the id column to each single INSERT statement
+ * which the query executes. Then lastInsertId() of the query returns
+ * the id. The query stays no SELECT query. Other queries are never
+ * changed. Must be called before the query is prepared.
+ * @param query         A query of this driver.
+ * @param column        The id column. The insert id column of the driver if empty.
+ */
+void KQPostgreSqlDriver::captureInsertId(QSqlQuery &query, const QString &column) const
+{
+    KQPostgreSqlResult* result = (KQPostgreSqlResult*)query.result();
+    if (result == NULL || result->driver() != this) {
+        return;
+    }
+    result->setInsertIdColumn(column.isEmpty() ? m_insertIdColumn : column);
+}
+
+/**
+ * Get the memory held by results of all drivers in this process.
+ * @return      The number of bytes.
+ */
+qint64 KQPostgreSqlDriver::processResultBytes()
+{
+    return liveResultBytes.load();
+}
+
+/**
+ * Enables or disables statistics. While enabled the driver counts
+ * connections, prepared and executed statements, received rows and
+ * decoded values. Disabling deletes all counters.
+ * If a slow query threshold is set then sampled SELECT statements
+ * which take longer are explained. The plan is kept in the statistics.
+ * It is the plan of EXPLAIN without ANALYZE. The statement is not
+ * executed a second time. Statements in a transaction are not explained.
+ * @param enabled       True to collect statistics.
+ */
+void KQPostgreSqlDriver::setStatisticsEnabled(const bool enabled)
+{
+    if (enabled && m_pStatistics == NULL) {
+        m_pStatistics = new KQPostgreSqlStatistics();
+    }
+    if (! enabled) {
+        delete m_pStatistics;
+        m_pStatistics = NULL;
+    }
+}
+
+/**
+ * Registers a SQL statement which is prepared right after open()
+ * and after each reconnect. The statement is prepared under the same
+ * name as QSqlQuery::prepare() would use. So the first prepare() of
+ * the query finds it without a round trip to the database.
+ * If the database is open the statement is prepared at once.
+ * @param name          A name to get the query back with registeredStatement().
+ * @param query         The SQL query string with placeholders.
+ */
+void KQPostgreSqlDriver::registerStatement(const QString &name, const QString &query)
+{
+    m_registeredStatements.insert(name, query);
+    if (isOpen()) {
+        prepareRegisteredStatements();
+    }
+}
+
+/**
+ * Splits a table into page ranges for a partitioned scan. Each
+ * partition is a condition on the ctid of the rows. The last
+ * partition has no upper bound to take pages which are added
+ * during the scan.
+ * The ctid conditions are executed as TID range scans from PostgreSql
+ * 14 on. Older servers would read the whole table for each partition.
+ * Therefore older servers are refused with an error.
+ * @param tableName     The table to scan.
+ * @param count         The number of partitions.
+ * @return              Conditions for execPartitioned() or an empty list.
+ */
+QStringList KQPostgreSqlDriver::ctidPartitions(const QString &tableName, const int count)
+{
+    QStringList conditions;
+    if (m_pConnection == NULL || count < 1) {
+        return conditions;
+    }
+    if (PQserverVersion(m_pConnection) < 140000) {
+        QSqlError error(QString("Ctid partitions need PostgreSql 14 or later !"),
+                        QString("Server version is %1").arg(PQserverVersion(m_pConnection)),
+                        QSqlError::StatementError);
+        setLastError(error);
+        return conditions;
+    }
+    const char* stmt = "SELECT pg_relation_size($1::regclass) / current_setting('block_size')::int";
+    QByteArray table = tableName.toUtf8();
+    const char* values[1] = { table.constData() };
+    PGresult* result = PQexecParams(m_pConnection, stmt, 1, NULL, values, NULL, NULL, 0);
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        QSqlError error(QString("Could not read table size !"), QString(PQresultErrorMessage(result)),
+                        QSqlError::StatementError);
+        setLastError(error);
+        PQclear(result);
+        return conditions;
+    }
+    qlonglong pages = QString(PQgetvalue(result, 0, 0)).toLongLong();
+    PQclear(result);
+    qlonglong pagesPerPartition = pages / count + 1;
+    QString lowerBound("ctid >= '(%1,0)'::tid");
+    QString upperBound(" AND ctid < '(%1,0)'::tid");
+    for (int partition=0; partition<count; ++partition) {
+        QString condition = lowerBound.arg(partition * pagesPerPartition);
+        if (partition < count - 1) {
+            condition.append(upperBound.arg((partition + 1) * pagesPerPartition));
+        }
+        conditions << condition;
+    }
+
+    return conditions;
+}
+
+/**
+ * Splits a key range into partitions for a partitioned scan.
+ * The ascending bounds split the key into bounds.size() + 1
+ * partitions. The first and the last partition are open.
+ * The key column is quoted.
+ * @param keyColumn     The column name of the key.
+ * @param bounds        Ascending key values where partitions are split.
+ * @return              Conditions for execPartitioned().
+ */
+QStringList KQPostgreSqlDriver::keyRangePartitions(const QString &keyColumn, const QVector<QVariant> &bounds) const
+{
+    QStringList conditions;
+    QString column = escapeIdentifier(keyColumn, QSqlDriver::FieldName);
+    QString lowerBound("%1 >= %2");
+    QString upperBound("%1 < %2");
+    QString previous;
+    foreach (const QVariant& bound, bounds) {
+        QSqlField field(keyColumn, bound.type());
+        field.setValue(bound);
+        QString value = formatValue(field);
+        if (previous.isNull()) {
+            conditions << upperBound.arg(column, value);
+        } else {
+            conditions << lowerBound.arg(column, previous) + QString(" AND ") + upperBound.arg(column, value);
+        }
+        previous = value;
+    }
+    if (previous.isNull()) {
+        conditions << QString("true");
+    } else {
+        conditions << lowerBound.arg(column, previous);
+    }
+
+    return conditions;
+}
+
+/**
+ * Executes a SELECT statement once for each partition. Each partition
+ * is sent to its own connection of a connection pool. The server
+ * executes all partitions concurrently.
+ * The statement template must contain a '%1' where the condition of
+ * a partition is inserted. For instance:
+ *      "SELECT * FROM measurement WHERE %1"
+ * The handler is called with the partition number and a query with
+ * the rows of this partition as soon as a partition is complete.
+ * @param stmtTemplate      A SELECT statement with a '%1' for the condition.
+ * @param conditions        The conditions of the partitions.
+ * @param handler           Is called once for each partition.
+ * @return                  True if all partitions are done without error.
+ */
+bool KQPostgreSqlDriver::execPartitioned(const QString &stmtTemplate, const QStringList &conditions,
+                                         const PartitionHandler &handler)
+{
+    int count = conditions.size();
+    if (! growPool(count)) {
+        return false;
+    }
+    QVector<bool> isRunning(count, false);
+    bool isSuccess = true;
+    for (int partition=0; partition<count; ++partition) {
+        QByteArray stmt = stmtTemplate.arg(conditions.at(partition)).toLocal8Bit();
+        if (PQsendQuery(m_pool.at(partition), stmt.data()) == 0) {
+            QSqlError error(QString("Could not send partition query !"), QString(PQerrorMessage(m_pool.at(partition))),
+                            QSqlError::StatementError);
+            setLastError(error);
+            isSuccess = false;
+            continue;
+        }
+        isRunning[partition] = true;
+    }
+    int running = isRunning.count(true);
+    while (running > 0) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        int maxSocket = -1;
+        for (int partition=0; partition<count; ++partition) {
+            if (isRunning.at(partition)) {
+                int socket = PQsocket(m_pool.at(partition));
+                if (socket < 0 || socket >= FD_SETSIZE) {
+                    QSqlError error(QString("Could not wait for partition query !"),
+                                    QString("Socket %1 can not be used with select()").arg(socket),
+                                    QSqlError::ConnectionError);
+                    setLastError(error);
+                    // Discard the running queries.
+                    closePool();
+                    return false;
+                }
+                FD_SET(socket, &readSet);
+                maxSocket = qMax(maxSocket, socket);
+            }
+        }
+        if (select(maxSocket + 1, &readSet, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            QSqlError error(QString("Could not wait for partition query !"), QString(strerror(errno)),
+                            QSqlError::ConnectionError);
+            setLastError(error);
+            closePool();
+            return false;
+        }
+        for (int partition=0; partition<count; ++partition) {
+            PGconn* pConnection = m_pool.at(partition);
+            if (! isRunning.at(partition) || ! FD_ISSET(PQsocket(pConnection), &readSet)) {
+                continue;
+            }
+            PQconsumeInput(pConnection);
+            while (isRunning.at(partition) && ! PQisBusy(pConnection)) {
+                PGresult* result = PQgetResult(pConnection);
+                if (result == NULL) {
+                    isRunning[partition] = false;
+                    --running;
+                    break;
+                }
+                if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+                    QSqlError error(QString("Could not execute partition query !"), QString(PQresultErrorMessage(result)),
+                                    QSqlError::StatementError, QString(PQresStatus(PQresultStatus(result))));
+                    setLastError(error);
+                    isSuccess = false;
+                    PQclear(result);
+                    continue;
+                }
+                QSqlQuery query = createQuery(result);
+                handler(partition, query);
+            }
+        }
+    }
+
+    return isSuccess;
+}
+
+/**
+ * Creates a query which takes an existing result. The result is
+ * deleted with the query. This gives access to results which were
+ * not received by a query. For instance results of a partitioned
+ * scan or results built by KQPostgreSqlSyntheticResult.
+ * @param pResult       A result with status PGRES_TUPLES_OK.
+ * @return              A query positioned before the first row.
+ */
+QSqlQuery KQPostgreSqlDriver::createQuery(PGresult *pResult) const
+{
+    KQPostgreSqlResult* result = new KQPostgreSqlResult(this);
+    result->adoptResult(pResult);
+
+    return QSqlQuery(result);
 }
 
 /**
@@ -55,7 +440,7 @@ bool KQPostgreSqlDriver::hasFeature(QSqlDriver::DriverFeature f) const
         return true;
         break;
     case QSqlDriver::BLOB:
-        return false;
+        return true;
         break;
     case QSqlDriver::Unicode:
         return false;
@@ -67,7 +452,7 @@ bool KQPostgreSqlDriver::hasFeature(QSqlDriver::DriverFeature f) const
         return true;
         break;
     case QSqlDriver::LastInsertId:
-        return false;
+        return ! m_insertIdColumn.isEmpty();
         break;
     case QSqlDriver::BatchOperations:
         return false;
@@ -85,7 +470,7 @@ bool KQPostgreSqlDriver::hasFeature(QSqlDriver::DriverFeature f) const
         return true;
         break;
     case QSqlDriver::MultipleResultSets:
-        return false;
+        return true;
         break;
     case QSqlDriver::CancelQuery:
         return false;
@@ -99,16 +484,21 @@ bool KQPostgreSqlDriver::hasFeature(QSqlDriver::DriverFeature f) const
 
 /**
  * Override
- * Close an open database connection.
+ * Close the database connection. Pool and replica connections are
+ * closed as well. A broken primary connection is released too.
  */
 void KQPostgreSqlDriver::close()
 {
-    if (m_pConnection && isOpen()) {
+    closePool();
+    closeReplicas();
+    m_preparedNames.clear();
+    if (m_pConnection) {
         PQfinish(m_pConnection);
         m_pConnection = NULL;
-        setOpenError(false);
-        setOpen(false);
+        ++m_connectionSerial;
     }
+    setOpenError(false);
+    setOpen(false);
 }
 
 /**
@@ -136,30 +526,58 @@ bool KQPostgreSqlDriver::open(const QString &db, const QString &user, const QStr
                               const QString &host, int port, const QString &connOpts)
 {
     qDebug() << "Driver: Open database ...";
-    if (isOpen()) {
-        close();
+    // Release all connections of a former call. Even if they are broken.
+    close();
+    m_database = db;
+    m_user = user;
+    m_password = password;
+    m_connOpts = connOpts;
+    // The host parameter can take a comma seperated list of primary hosts.
+    m_primaries.clear();
+    QStringList hostList = host.split(QChar(','), QString::SkipEmptyParts);
+    foreach (const QString& hostName, hostList) {
+        Host entry = { hostName.trimmed(), port, Primary, NULL, -1 };
+        m_primaries.append(entry);
     }
-    qDebug() << "Driver: Create connection string ...";
-    QString prototype("host=%1 port=%2 dbname=%3 user=%4 password=%5");
-    QString connectionInfo = prototype.arg(host).arg(port).arg(db).arg(user).arg(password);
-    if (! connOpts.isEmpty()) {
-        QString options = QString(connOpts).replace(QChar(';'), QChar(' '));
-        connectionInfo.append(' ').append(options);
+    foreach (const Host& entry, m_hosts) {
+        if (entry.role == Primary) {
+            m_primaries.append(entry);
+        }
     }
-    qDebug() << "Connection string: " << connectionInfo;
-    QByteArray info = connectionInfo.toLocal8Bit();
-    m_pConnection = PQconnectdb(info.data());
-    ConnStatusType status = PQstatus(m_pConnection);
-    if (status == CONNECTION_BAD) {
-        QSqlError error(QString("Could not open database !"), QString(PQerrorMessage(m_pConnection)),
-                        QSqlError::ConnectionError);
+    if (m_primaries.isEmpty()) {
+        Host entry = { host, port, Primary, NULL, -1 };
+        m_primaries.append(entry);
+    }
+    QString errorMessage;
+    for (int index=0; index<m_primaries.size(); ++index) {
+        m_pConnection = connectTo(m_primaries[index], errorMessage);
+        if (m_pConnection) {
+            m_primaryIndex = index;
+            break;
+        }
+    }
+    if (m_pConnection == NULL) {
+        QSqlError error(QString("Could not open database !"), errorMessage, QSqlError::ConnectionError);
         setLastError(error);
         setOpenError(true);
-        PQfinish(m_pConnection);
-        m_pConnection = NULL;
 
         return false;
     }
+    // Replicas are optional. A replica which can not be reached is left out.
+    m_nextReplica = 0;
+    foreach (const Host& entry, m_hosts) {
+        if (entry.role != Replica) {
+            continue;
+        }
+        Host replica = entry;
+        replica.pConnection = connectTo(replica, errorMessage);
+        if (replica.pConnection == NULL) {
+            qWarning() << "Driver: Replica is not available: " << errorMessage;
+            continue;
+        }
+        m_replicas.append(replica);
+    }
+    prepareRegisteredStatements();
     setOpenError(false);
 
     return true;
@@ -240,6 +658,31 @@ QSqlRecord KQPostgreSqlDriver::record(const QString &tableName) const
     return info;
 }
 
+/**
+ * Override
+ * Quotes an identifier. Quotes within the name are doubled. The schema
+ * and the name of a table name are quoted one by one:
+ *      public.measurement  ->  "public"."measurement"
+ * A quoted identifier is not quoted again. A quoted name is case sensitive.
+ * @param identifier        A table or field name.
+ * @param type              TableName or FieldName.
+ * @return                  The quoted identifier.
+ */
+QString KQPostgreSqlDriver::escapeIdentifier(const QString &identifier, QSqlDriver::IdentifierType type) const
+{
+    QString escaped = identifier;
+    if (identifier.isEmpty() || isIdentifierEscaped(identifier, type)) {
+        return escaped;
+    }
+    escaped.replace(QChar('"'), QString("\"\""));
+    if (type == QSqlDriver::TableName) {
+        escaped.replace(QChar('.'), QString("\".\""));
+    }
+    escaped.prepend(QChar('"')).append(QChar('"'));
+
+    return escaped;
+}
+
 /**
  * Seperate tablename from schema name.
  * These names are seperated via a dot in the string.
@@ -258,3 +701,395 @@ bool KQPostgreSqlDriver::splitSchemaName(QString &tablename, QString &schemaName
 
     return true;
 }
+
+/**
+ * Protected
+ * Get a connection for a read only statement. If replicas are
+ * connected then one of them is choosen by the read routing.
+ * RoundRobin takes the replicas in turn. LeastLatency takes
+ * the replica with the least latency. The latency is measured
+ * at connection setup and updated with the time of each query
+ * on the replica. See addReadLatency().
+ * Within a transaction the primary connection is returned. The
+ * statement must see changes of the transaction.
+ * A broken replica connection is reset. If it can not be reset
+ * the replica is skipped.
+ * @return          A connection to a replica or the primary connection.
+ */
+PGconn *KQPostgreSqlDriver::readConnection()
+{
+    if (m_replicas.isEmpty() || m_pConnection == NULL) {
+        return m_pConnection;
+    }
+    if (PQtransactionStatus(m_pConnection) != PQTRANS_IDLE) {
+        return m_pConnection;
+    }
+    int count = m_replicas.size();
+    int selected = -1;
+    for (int attempt=0; attempt<count; ++attempt) {
+        int index = (m_nextReplica + attempt) % count;
+        Host& replica = m_replicas[index];
+        if (PQstatus(replica.pConnection) == CONNECTION_BAD) {
+            PQreset(replica.pConnection);
+            if (PQstatus(replica.pConnection) == CONNECTION_BAD) {
+                continue;
+            }
+        }
+        if (m_readRouting == RoundRobin) {
+            selected = index;
+            break;
+        }
+        if (selected < 0 || replica.latency < m_replicas.at(selected).latency) {
+            selected = index;
+        }
+    }
+    if (selected < 0) {
+        return m_pConnection;
+    }
+    m_nextReplica = (selected + 1) % count;
+
+    return m_replicas.at(selected).pConnection;
+}
+
+/**
+ * Private
+ * Updates the latency of a replica with the time of a query. The
+ * latency is a moving average. So LeastLatency routing follows the
+ * load of the replicas. Each query on a replica lowers the latency
+ * of the other replicas a little. So a replica is tried again after a
+ * slow query. Queries on the primary connection are ignored.
+ * @param pConnection       The connection which executed the query.
+ * @param microseconds      The time of the query.
+ */
+void KQPostgreSqlDriver::addReadLatency(const PGconn *pConnection, const qint64 microseconds)
+{
+    if (m_readRouting != LeastLatency || pConnection == m_pConnection) {
+        return;
+    }
+    for (int index=0; index<m_replicas.size(); ++index) {
+        Host& replica = m_replicas[index];
+        if (replica.pConnection == pConnection) {
+            replica.latency = (replica.latency * 7 + microseconds) / 8;
+        } else {
+            replica.latency -= replica.latency / 16;
+        }
+    }
+}
+
+/**
+ * Protected
+ * Replaces a lost primary connection. Starting with the current primary
+ * host each primary host is tried once.
+ * @return          True if a new primary connection is established.
+ */
+bool KQPostgreSqlDriver::failover()
+{
+    // Pool connections belong to the lost host.
+    closePool();
+    if (m_pConnection) {
+        PQfinish(m_pConnection);
+        m_pConnection = NULL;
+    }
+    ++m_connectionSerial;
+    m_preparedNames.clear();
+    QString errorMessage;
+    int count = m_primaries.size();
+    for (int attempt=0; attempt<count; ++attempt) {
+        int index = (m_primaryIndex + attempt) % count;
+        m_pConnection = connectTo(m_primaries[index], errorMessage);
+        if (m_pConnection) {
+            qDebug() << "Driver: Failover to " << m_primaries.at(index).name;
+            m_primaryIndex = index;
+            prepareRegisteredStatements();
+            return true;
+        }
+    }
+    QSqlError error(QString("Connection lost. No primary host is available !"), errorMessage,
+                    QSqlError::ConnectionError);
+    setLastError(error);
+    setOpenError(true);
+
+    return false;
+}
+
+/**
+ * Private
+ * Builds the connection string for a host. Takes database name,
+ * user, password and options of the last call to open(). The values
+ * are quoted. The options are taken as they are.
+ * @param host          The host name or address.
+ * @param port          The port number on this host.
+ * @return              A libpq connection string.
+ */
+QString KQPostgreSqlDriver::connectionString(const QString &host, const int port) const
+{
+    QString connectionInfo = QString("host=%1 port=%2 dbname=%3 user=%4 password=%5")
+            .arg(connectionValue(host), QString::number(port), connectionValue(m_database),
+                 connectionValue(m_user), connectionValue(m_password));
+    if (! m_connOpts.isEmpty()) {
+        QString options = QString(m_connOpts).replace(QChar(';'), QChar(' '));
+        connectionInfo.append(' ').append(options);
+    }
+
+    return connectionInfo;
+}
+
+/**
+ * Private
+ * Quotes a value of a connection string. Backslashes and single
+ * quotes are escaped with a backslash. So a value can contain blanks,
+ * quotes and '=' without breaking the connection string.
+ * @param value         A value of a connection string.
+ * @return              The value in single quotes.
+ */
+QString KQPostgreSqlDriver::connectionValue(const QString &value)
+{
+    QString quoted = value;
+    quoted.replace(QChar('\\'), QString("\\\\")).replace(QChar('\''), QString("\\'"));
+
+    return quoted.prepend(QChar('\'')).append(QChar('\''));
+}
+
+/**
+ * Private
+ * Opens a connection to a host. The time to connect is kept as
+ * latency of the host.
+ * @param host              The host to connect to.
+ * @param errorMessage      Is set to the error message if connection fails.
+ * @return                  A connection or NULL.
+ */
+PGconn *KQPostgreSqlDriver::connectTo(Host &host, QString &errorMessage) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray info = connectionString(host.name, host.port).toLocal8Bit();
+    PGconn* pConnection = PQconnectdb(info.data());
+    host.latency = timer.nsecsElapsed() / 1000;
+    if (m_pStatistics) {
+        m_pStatistics->addConnect(host.latency);
+    }
+    if (PQstatus(pConnection) == CONNECTION_BAD) {
+        errorMessage = QString(PQerrorMessage(pConnection));
+        PQfinish(pConnection);
+        return NULL;
+    }
+
+    return pConnection;
+}
+
+/**
+ * Private
+ * Opens connections to the current primary host until the pool
+ * has the given size.
+ * @param size          The number of required connections.
+ * @return              True if the pool has enough connections.
+ */
+bool KQPostgreSqlDriver::growPool(const int size)
+{
+    if (m_pConnection == NULL) {
+        return false;
+    }
+    QString errorMessage;
+    while (m_pool.size() < size) {
+        PGconn* pConnection = connectTo(m_primaries[m_primaryIndex], errorMessage);
+        if (pConnection == NULL) {
+            QSqlError error(QString("Could not open pool connection !"), errorMessage, QSqlError::ConnectionError);
+            setLastError(error);
+            return false;
+        }
+        m_pool.append(pConnection);
+    }
+
+    return true;
+}
+
+/**
+ * Private
+ * Close all pool connections.
+ */
+void KQPostgreSqlDriver::closePool()
+{
+    foreach (PGconn* pConnection, m_pool) {
+        PQfinish(pConnection);
+    }
+    m_pool.clear();
+}
+
+/**
+ * Private
+ * Accounts memory of results. Is called by results when they take
+ * or delete a PGresult.
+ * @param bytes         The change of memory. Negative if memory is freed.
+ */
+void KQPostgreSqlDriver::addResultBytes(const qint64 bytes)
+{
+    m_resultBytes += bytes;
+    addProcessResultBytes(bytes);
+}
+
+/**
+ * Private
+ * Accounts memory of results for the whole process only. Is used by
+ * results which outlive their driver.
+ * @param bytes         The change of memory. Negative if memory is freed.
+ */
+void KQPostgreSqlDriver::addProcessResultBytes(const qint64 bytes)
+{
+    liveResultBytes.fetchAndAddRelaxed(bytes);
+}
+
+/**
+ * Private
+ * Decides if a statement is a slow query which is to be explained.
+ * Slow queries are sampled. Each n-th slow query is explained where
+ * n is the explain sample rate. Requires enabled statistics and a
+ * slow query threshold.
+ * @param microseconds      The time to execute the statement.
+ * @return                  True if the statement is to be explained.
+ */
+bool KQPostgreSqlDriver::isSlowQuerySample(const qint64 microseconds)
+{
+    if (m_pStatistics == NULL || m_slowQueryThreshold <= 0 || microseconds < m_slowQueryThreshold * 1000LL) {
+        return false;
+    }
+
+    return (m_slowQueryCount++ % m_explainSampleRate) == 0;
+}
+
+/**
+ * Private
+ * Reads the types of all columns of a table.
+ * @param tableName     The escaped table name. Can have a schema name.
+ * @return              The SQL type of each column by column name.
+ */
+QHash<QString, QString> KQPostgreSqlDriver::columnTypes(const QString &tableName) const
+{
+    QHash<QString, QString> types;
+    const char* stmt = "SELECT attname, format_type(atttypid, atttypmod) FROM pg_attribute "
+                       "WHERE attrelid = $1::regclass AND attnum > 0 AND NOT attisdropped";
+    QByteArray table = tableName.toUtf8();
+    const char* values[1] = { table.constData() };
+    PGresult* result = PQexecParams(m_pConnection, stmt, 1, NULL, values, NULL, NULL, 0);
+    if (PQresultStatus(result) == PGRES_TUPLES_OK) {
+        int rowCount = PQntuples(result);
+        for (int row=0; row<rowCount; ++row) {
+            types.insert(QString::fromUtf8(PQgetvalue(result, row, 0)), QString::fromUtf8(PQgetvalue(result, row, 1)));
+        }
+    }
+    PQclear(result);
+
+    return types;
+}
+
+/**
+ * Private
+ * Builds a PostgreSql array literal with the values of one column.
+ * For instance: {"1","two",NULL}
+ * @param rows          The rows.
+ * @param column        The column number within a row.
+ * @return              The array literal.
+ */
+QString KQPostgreSqlDriver::arrayLiteral(const QVector<QVector<QVariant> > &rows, const int column) const
+{
+    QStringList elements;
+    foreach (const QVector<QVariant>& row, rows) {
+        QVariant value = row.value(column);
+        if (value.isNull()) {
+            elements << QString("NULL");
+            continue;
+        }
+        QString text;
+        switch (value.type()) {
+        case QVariant::Bool:
+            text = value.toBool() ? QString("t") : QString("f");
+            break;
+        case QVariant::ByteArray:
+            text = QString("\\x").append(QString::fromLatin1(value.toByteArray().toHex()));
+            break;
+        default:
+            text = value.toString();
+            break;
+        }
+        text.replace(QChar('\\'), QString("\\\\")).replace(QChar('"'), QString("\\\""));
+        elements << QString("\"%1\"").arg(text);
+    }
+
+    return QString("{%1}").arg(elements.join(QChar(',')));
+}
+
+/**
+ * Private
+ * Close all replica connections.
+ */
+void KQPostgreSqlDriver::closeReplicas()
+{
+    for (int index=0; index<m_replicas.size(); ++index) {
+        PQfinish(m_replicas[index].pConnection);
+    }
+    m_replicas.clear();
+}
+
+/**
+ * Private
+ * Prepares all registered statements on the primary connection. If
+ * libpq supports pipelining all statements are sent in one burst and
+ * there is only one round trip. Otherwise they are prepared one by one.
+ * A statement which can not be prepared is prepared later by prepare().
+ * In a pipeline a failed statement aborts all following statements.
+ */
+void KQPostgreSqlDriver::prepareRegisteredStatements()
+{
+    if (m_pConnection == NULL || m_registeredStatements.isEmpty()) {
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    KQPostgreSqlResult result(this);
+    QStringList names;
+    QList<QByteArray> statements;
+    foreach (const QString& query, m_registeredStatements) {
+        QString stmtName = KQPostgreSqlResult::statementName(query);
+        if (m_preparedNames.contains(stmtName) || names.contains(stmtName)) {
+            continue;
+        }
+        names.append(stmtName);
+        statements.append(result.statementText(query).toLocal8Bit());
+    }
+    int sentCount = 0;
+#ifdef LIBPQ_HAS_PIPELINING
+    if (PQenterPipelineMode(m_pConnection) == 1) {
+        for (; sentCount<names.size(); ++sentCount) {
+            QByteArray stmtName = names.at(sentCount).toLocal8Bit();
+            if (PQsendPrepare(m_pConnection, stmtName.data(), statements.at(sentCount).data(), 0, NULL) == 0) {
+                break;
+            }
+        }
+        PQpipelineSync(m_pConnection);
+        // Each statement gives a result followed by NULL. The sync gives one more result.
+        for (int index=0; index<sentCount; ++index) {
+            PGresult* pResult = PQgetResult(m_pConnection);
+            if (PQresultStatus(pResult) == PGRES_COMMAND_OK) {
+                m_preparedNames.insert(names.at(index));
+            } else {
+                qWarning() << "Driver: Could not prepare registered statement: " << PQresultErrorMessage(pResult);
+            }
+            PQclear(pResult);
+            PQclear(PQgetResult(m_pConnection));
+        }
+        PQclear(PQgetResult(m_pConnection));
+        PQexitPipelineMode(m_pConnection);
+    }
+#endif
+    for (int index=sentCount; index<names.size(); ++index) {
+        PGresult* pResult = PQprepare(m_pConnection, names.at(index).toLocal8Bit().data(), statements.at(index).data(), 0, NULL);
+        if (PQresultStatus(pResult) == PGRES_COMMAND_OK) {
+            m_preparedNames.insert(names.at(index));
+        } else {
+            qWarning() << "Driver: Could not prepare registered statement: " << PQresultErrorMessage(pResult);
+        }
+        PQclear(pResult);
+    }
+    if (m_pStatistics) {
+        m_pStatistics->addPrepare(timer.nsecsElapsed() / 1000);
+    }
+}
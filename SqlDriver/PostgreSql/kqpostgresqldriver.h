@@ -1,21 +1,79 @@
 #ifndef KQPOSTGRESQLDRIVER_H
 #define KQPOSTGRESQLDRIVER_H
 
+#include "kqpostgresqlstatistics.h"
 #include <libpq-fe.h>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QString>
 #include <QSqlRecord>
+#include <QSqlQuery>
+#include <QVector>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <functional>
 
 class KQPostgreSqlResult;
 
 class KQPostgreSqlDriver : public QSqlDriver
 {
+    friend class KQPostgreSqlResult;
+    friend class KQPostgreSqlLargeObject;
+    friend class KQPostgreSqlByteaReader;
 
 public:
+    enum HostRole { Primary, Replica };
+    enum ReadRouting { RoundRobin, LeastLatency };
+    typedef std::function<void(int partition, QSqlQuery& query)> PartitionHandler;
+
     KQPostgreSqlDriver();
     ~KQPostgreSqlDriver();
 
+    // Host list and read routing
+    void addHost(const QString& host, const int port, const HostRole role = Replica);
+    void clearHosts();
+    void setReadRouting(const ReadRouting routing)         { m_readRouting = routing; }
+    ReadRouting readRouting() const                         { return m_readRouting; }
+
+    // Row prefetch
+    void setRowPrefetch(const int rows)                     { m_rowPrefetch = rows; }
+    int rowPrefetch() const                                 { return m_rowPrefetch; }
+
+    // Insert id and upsert
+    void setInsertIdColumn(const QString& column)           { m_insertIdColumn = column; }
+    QString insertIdColumn() const                          { return m_insertIdColumn; }
+    void captureInsertId(QSqlQuery& query, const QString& column = QString()) const;
+    QSqlQuery upsert(const QString& tableName, const QStringList& columns, const QVector<QVector<QVariant> >& rows,
+                     const QStringList& conflictColumns, const QString& returning = QString());
+
+    // Result memory
+    void setResultSizeLimit(const qint64 bytes)            { m_resultSizeLimit = bytes; }
+    qint64 resultSizeLimit() const                          { return m_resultSizeLimit; }
+    qint64 resultBytes() const                              { return m_resultBytes; }
+    static qint64 processResultBytes();
+
+    // Statistics
+    void setStatisticsEnabled(const bool enabled);
+    bool isStatisticsEnabled() const                        { return m_pStatistics != NULL; }
+    const KQPostgreSqlStatistics* statistics() const        { return m_pStatistics; }
+    void setSlowQueryThreshold(const int milliseconds)      { m_slowQueryThreshold = milliseconds; }
+    int slowQueryThreshold() const                          { return m_slowQueryThreshold; }
+    void setExplainSampleRate(const int rate)               { m_explainSampleRate = qMax(1, rate); }
+    int explainSampleRate() const                           { return m_explainSampleRate; }
+
+    // Prepared statement warm-up
+    void registerStatement(const QString& name, const QString& query);
+    QString registeredStatement(const QString& name) const  { return m_registeredStatements.value(name); }
+    void clearRegisteredStatements()                        { m_registeredStatements.clear(); }
+
+    // Partitioned table scan
+    QStringList ctidPartitions(const QString& tableName, const int count);
+    QStringList keyRangePartitions(const QString& keyColumn, const QVector<QVariant>& bounds) const;
+    bool execPartitioned(const QString& stmtTemplate, const QStringList& conditions, const PartitionHandler& handler);
+
+    QSqlQuery createQuery(PGresult* pResult) const;
+
 signals:
 
 public slots:
@@ -34,12 +92,62 @@ public:
               const QString &connOpts = QString()) override;
     bool isOpen() const override;
     QSqlRecord record(const QString &tableName) const override;
+    QString escapeIdentifier(const QString &identifier, IdentifierType type) const override;
 
 protected:
     bool splitSchemaName(QString& tablename, QString& schemaName) const;
+    PGconn* connection() const                              { return m_pConnection; }
+    quint64 connectionSerial() const                        { return m_connectionSerial; }
+    PGconn* readConnection();
+    bool failover();
+
+private:
+    struct Host {
+        QString name;
+        int port;
+        HostRole role;
+        PGconn* pConnection;
+        qint64 latency;
+    };
+
+    QString connectionString(const QString& host, const int port) const;
+    static QString connectionValue(const QString& value);
+    PGconn* connectTo(Host& host, QString& errorMessage) const;
+    void closeReplicas();
+    void addReadLatency(const PGconn* pConnection, const qint64 microseconds);
+    void addResultBytes(const qint64 bytes);
+    static void addProcessResultBytes(const qint64 bytes);
+    bool isSlowQuerySample(const qint64 microseconds);
+    QHash<QString, QString> columnTypes(const QString& tableName) const;
+    QString arrayLiteral(const QVector<QVector<QVariant> >& rows, const int column) const;
+    void closePool();
+    bool growPool(const int size);
+    void prepareRegisteredStatements();
 
 private:
     PGconn* m_pConnection;
+    quint64 m_connectionSerial;
+    QVector<Host> m_hosts;
+    QVector<Host> m_primaries;
+    QVector<Host> m_replicas;
+    QVector<PGconn*> m_pool;
+    KQPostgreSqlStatistics* m_pStatistics;
+    int m_slowQueryThreshold;
+    int m_explainSampleRate;
+    quint64 m_slowQueryCount;
+    int m_rowPrefetch;
+    qint64 m_resultSizeLimit;
+    qint64 m_resultBytes;
+    QString m_insertIdColumn;
+    QHash<QString, QString> m_registeredStatements;
+    QSet<QString> m_preparedNames;
+    int m_primaryIndex;
+    int m_nextReplica;
+    ReadRouting m_readRouting;
+    QString m_database;
+    QString m_user;
+    QString m_password;
+    QString m_connOpts;
 };
 
 #endif // KQPOSTGRESQLDRIVER_H
@@ -0,0 +1,225 @@
+#include "kqpostgresqllargeobject.h"
+#include <libpq/libpq-fs.h>
+#include <climits>
+#include <cstdio>
+
+
+/**
+ * Constructor
+ * The large object is not opened. Call open() before reading or writing.
+ * @param pDriver       An open driver.
+ * @param objectId      The Oid of an existing large object.
+ * @param parent        A parent object or NULL.
+ */
+KQPostgreSqlLargeObject::KQPostgreSqlLargeObject(KQPostgreSqlDriver *pDriver, const Oid objectId, QObject *parent) :
+    QIODevice(parent),
+    m_pDriver(pDriver),
+    m_connectionSerial(0),
+    m_objectId(objectId),
+    m_descriptor(-1),
+    m_hasTransaction(false)
+{
+
+}
+
+/**
+ * Destructor
+ * Closes the large object if it is open.
+ */
+KQPostgreSqlLargeObject::~KQPostgreSqlLargeObject()
+{
+    if (isOpen()) {
+        close();
+    }
+}
+
+/**
+ * Creates a new and empty large object.
+ * @param pDriver       An open driver.
+ * @return              The Oid of the new large object or InvalidOid.
+ */
+Oid KQPostgreSqlLargeObject::create(KQPostgreSqlDriver *pDriver)
+{
+    return lo_creat(pDriver->connection(), INV_READ | INV_WRITE);
+}
+
+/**
+ * Deletes a large object from the database.
+ * @param pDriver       An open driver.
+ * @param objectId      The Oid of the large object.
+ * @return              True if large object is deleted.
+ */
+bool KQPostgreSqlLargeObject::remove(KQPostgreSqlDriver *pDriver, const Oid objectId)
+{
+    return lo_unlink(pDriver->connection(), objectId) == 1;
+}
+
+/**
+ * Override
+ * Opens the large object. Starts a transaction if the connection is
+ * not within a transaction. The device is always opened unbuffered.
+ * @param mode      ReadOnly, WriteOnly or ReadWrite.
+ * @return          True if large object is open.
+ */
+bool KQPostgreSqlLargeObject::open(QIODevice::OpenMode mode)
+{
+    if (isOpen() || m_pDriver.isNull() || ! m_pDriver->isOpen()) {
+        return false;
+    }
+    m_connectionSerial = m_pDriver->connectionSerial();
+    PGconn* pConnection = m_pDriver->connection();
+    if (PQtransactionStatus(pConnection) == PQTRANS_IDLE) {
+        PGresult* result = PQexec(pConnection, "BEGIN");
+        m_hasTransaction = (PQresultStatus(result) == PGRES_COMMAND_OK);
+        PQclear(result);
+        if (! m_hasTransaction) {
+            setErrorString(QString(PQerrorMessage(pConnection)));
+            return false;
+        }
+    }
+    int loMode = 0;
+    if (mode & QIODevice::ReadOnly) {
+        loMode |= INV_READ;
+    }
+    if (mode & QIODevice::WriteOnly) {
+        loMode |= INV_WRITE;
+    }
+    m_descriptor = lo_open(pConnection, m_objectId, loMode);
+    if (m_descriptor < 0) {
+        QString errorMessage(PQerrorMessage(pConnection));
+        close();
+        setErrorString(errorMessage);
+        return false;
+    }
+
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Override
+ * Closes the large object. A transaction which was started by
+ * open() is commited. If the commit fails then errorString() tells
+ * why. Written data is lost in this case.
+ */
+void KQPostgreSqlLargeObject::close()
+{
+    PGconn* pConnection = connection();
+    if (pConnection == NULL) {
+        m_descriptor = -1;
+        m_hasTransaction = false;
+        QIODevice::close();
+        setErrorString(QString("Connection was closed or replaced !"));
+        return;
+    }
+    if (m_descriptor >= 0) {
+        lo_close(pConnection, m_descriptor);
+        m_descriptor = -1;
+    }
+    QString errorMessage;
+    if (m_hasTransaction) {
+        PGresult* result = PQexec(pConnection, "COMMIT");
+        if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+            errorMessage = QString(PQresultErrorMessage(result));
+        }
+        PQclear(result);
+        m_hasTransaction = false;
+    }
+    QIODevice::close();
+    if (! errorMessage.isEmpty()) {
+        setErrorString(errorMessage);
+    }
+}
+
+/**
+ * Override
+ * Get the size of the large object in bytes.
+ * @return      The size or -1 if the large object is not open.
+ */
+qint64 KQPostgreSqlLargeObject::size() const
+{
+    PGconn* pConnection = connection();
+    if (m_descriptor < 0 || pConnection == NULL) {
+        return -1;
+    }
+    pg_int64 position = lo_tell64(pConnection, m_descriptor);
+    pg_int64 end = lo_lseek64(pConnection, m_descriptor, 0, SEEK_END);
+    lo_lseek64(pConnection, m_descriptor, position, SEEK_SET);
+
+    return end;
+}
+
+/**
+ * Override
+ * Sets the position for the next read or write.
+ * @param pos       The byte offset from the begin of the large object.
+ * @return          True if position is set.
+ */
+bool KQPostgreSqlLargeObject::seek(qint64 pos)
+{
+    PGconn* pConnection = connection();
+    if (m_descriptor < 0 || pConnection == NULL || ! QIODevice::seek(pos)) {
+        return false;
+    }
+
+    return lo_lseek64(pConnection, m_descriptor, pos, SEEK_SET) == pos;
+}
+
+/**
+ * Override
+ * Reads one chunk from the large object.
+ * @param data          A buffer for the data.
+ * @param maxSize       The size of the buffer.
+ * @return              The number of bytes read or -1 on error.
+ */
+qint64 KQPostgreSqlLargeObject::readData(char *data, qint64 maxSize)
+{
+    PGconn* pConnection = connection();
+    if (pConnection == NULL) {
+        setErrorString(QString("Connection was closed or replaced !"));
+        return -1;
+    }
+    size_t length = (size_t)qMin(maxSize, (qint64)INT_MAX);
+    int bytesRead = lo_read(pConnection, m_descriptor, data, length);
+    if (bytesRead < 0) {
+        setErrorString(QString(PQerrorMessage(pConnection)));
+    }
+
+    return bytesRead;
+}
+
+/**
+ * Override
+ * Writes one chunk to the large object.
+ * @param data          The data to write.
+ * @param maxSize       The number of bytes to write.
+ * @return              The number of bytes written or -1 on error.
+ */
+qint64 KQPostgreSqlLargeObject::writeData(const char *data, qint64 maxSize)
+{
+    PGconn* pConnection = connection();
+    if (pConnection == NULL) {
+        setErrorString(QString("Connection was closed or replaced !"));
+        return -1;
+    }
+    size_t length = (size_t)qMin(maxSize, (qint64)INT_MAX);
+    int bytesWritten = lo_write(pConnection, m_descriptor, data, length);
+    if (bytesWritten < 0) {
+        setErrorString(QString(PQerrorMessage(pConnection)));
+    }
+
+    return bytesWritten;
+}
+
+/**
+ * Private
+ * Get the connection of the large object descriptor.
+ * @return      The connection or NULL if the driver closed or replaced it.
+ */
+PGconn *KQPostgreSqlLargeObject::connection() const
+{
+    if (m_pDriver.isNull() || m_pDriver->connectionSerial() != m_connectionSerial) {
+        return NULL;
+    }
+
+    return m_pDriver->connection();
+}
@@ -0,0 +1,59 @@
+#ifndef KQPOSTGRESQLLARGEOBJECT_H
+#define KQPOSTGRESQLLARGEOBJECT_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlLargeObject
+ * -------------------------------------------------------------------------------------
+ * Streams a PostgreSql large object. The object is read and written in chunks
+ * with lo_read() and lo_write(). The device is unbuffered. Each read() or write()
+ * call transfers one chunk of the size given by the caller. A large object can
+ * be copied with a buffer of fixed size.
+ *
+ * Large object descriptors are only valid within a transaction. If the connection
+ * is not within a transaction then open() starts one and close() commits it.
+ * The descriptor belongs to the connection which was current at open(). If the
+ * driver replaces this connection, for instance by a failover, then the device
+ * fails each further call. It must be opened again.
+ */
+
+#include "kqpostgresqldriver.h"
+#include <QIODevice>
+#include <QPointer>
+
+
+class KQPostgreSqlLargeObject : public QIODevice
+{
+public:
+    KQPostgreSqlLargeObject(KQPostgreSqlDriver* pDriver, const Oid objectId, QObject* parent = NULL);
+    ~KQPostgreSqlLargeObject();
+
+    static Oid create(KQPostgreSqlDriver* pDriver);
+    static bool remove(KQPostgreSqlDriver* pDriver, const Oid objectId);
+
+    Oid objectId() const                                { return m_objectId; }
+
+    // QIODevice interface
+public:
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override                  { return false; }
+    qint64 size() const override;
+    bool seek(qint64 pos) override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    PGconn* connection() const;
+
+private:
+    QPointer<KQPostgreSqlDriver> m_pDriver;
+    quint64 m_connectionSerial;
+    Oid m_objectId;
+    int m_descriptor;
+    bool m_hasTransaction;
+};
+
+#endif // KQPOSTGRESQLLARGEOBJECT_H
@@ -1,9 +1,15 @@
 #include "kqpostgresqlresult.h"
+#include "kqpostgresqldatetime.h"
+#include "kqpostgresqlbytea.h"
 #include <QDateTime>
 #include <QSqlField>
 #include <QSqlRecord>
 #include <QString>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QJsonDocument>
 #include <QDebug>
+#include <cstring>
 
 Q_DECLARE_OPAQUE_POINTER(PGresult*)
 Q_DECLARE_METATYPE(PGresult*)
@@ -19,7 +25,14 @@ Q_DECLARE_METATYPE(PGconn*)
 KQPostgreSqlResult::KQPostgreSqlResult(const QSqlDriver *driver) :
     QSqlResult(driver),
     m_pResult(NULL),
-    m_currentSize(-1)
+    m_currentSize(-1),
+    m_cacheFirstRow(-1),
+    m_cacheRows(0),
+    m_cacheFields(0),
+    m_heldBytes(0),
+    m_isSizeLimitExceeded(false),
+    m_isCopyRejected(false),
+    m_hasInsertId(false)
 {
     
 }
@@ -30,9 +43,7 @@ KQPostgreSqlResult::KQPostgreSqlResult(const QSqlDriver *driver) :
  */
 KQPostgreSqlResult::~KQPostgreSqlResult()
 {
-    if (m_pResult) {
-        PQclear(m_pResult);
-    }
+    clearResult();
 }
 
 /**
@@ -44,24 +55,74 @@ QVariant KQPostgreSqlResult::handle() const
     return QVariant::fromValue(m_pResult);
 }
 
+/**
+ * Get the whole result in columnar layout. Each column is decoded
+ * in one pass over the rows without creating QVariant objects.
+ * @return      A column for each field. Empty if there is no result or
+ *              if a column exceeds 2 GB of text.
+ */
+QVector<KQPostgreSqlColumn> KQPostgreSqlResult::columns() const
+{
+    QVector<KQPostgreSqlColumn> columnVector;
+    if (m_pResult == NULL || PQresultStatus(m_pResult) != PGRES_TUPLES_OK) {
+        return columnVector;
+    }
+    int fieldCount = PQnfields(m_pResult);
+    columnVector.reserve(fieldCount);
+    for (int field=0; field<fieldCount; ++field) {
+        KQPostgreSqlColumn column;
+        if (! KQPostgreSqlColumn::fromResult(m_pResult, field, column)) {
+            qWarning() << "Result: Column is too large: " << column.name();
+            return QVector<KQPostgreSqlColumn>();
+        }
+        columnVector.append(column);
+    }
+
+    return columnVector;
+}
+
 /**
  * Override
- * Get data of a field as QVariant.
+ * Get data of a field as QVariant. If rows were prefetched then
+ * the value is taken from the row cache.
  * @param i     Field number.
  * @return      The value as QVariant or QVariant().
  */
 QVariant KQPostgreSqlResult::data(int i)
 {
-    if (m_pResult == NULL || i > PQnfields(m_pResult)) {
+    int cacheRow = at() - m_cacheFirstRow;
+    if (cacheRow >= 0 && cacheRow < m_cacheRows && i >= 0 && i < m_cacheFields) {
+        return m_rowCache.at(cacheRow * m_cacheFields + i);
+    }
+    if (m_pResult == NULL || i < 0 || i >= PQnfields(m_pResult)) {
         qWarning("Field number is out of range. Or has no result.");
         return QVariant();
     }
     Oid typeOid = PQftype(m_pResult, i);
-    QVariant::Type dataType = variantTypeFromPostgreType(typeOid);
-    if (PQgetisnull(m_pResult, at(), i)) {
+
+    return decodeValue(at(), i, typeOid, variantTypeFromPostgreType(typeOid));
+}
+
+/**
+ * Private
+ * Converts a value of the result into a QVariant.
+ * @param row           The row number.
+ * @param field         The field number.
+ * @param typeOid       The PostgreSql type of the field.
+ * @param dataType      The QVariant type of the field.
+ * @return              The value as QVariant.
+ */
+QVariant KQPostgreSqlResult::decodeValue(const int row, const int field, const Oid typeOid, const QVariant::Type dataType) const
+{
+    KQPostgreSqlDriver* pDriver = pgDriver();
+    KQPostgreSqlStatistics* pStatistics = pDriver ? pDriver->m_pStatistics : NULL;
+    if (pStatistics) {
+        pStatistics->addDecode(typeOid);
+    }
+    if (PQgetisnull(m_pResult, row, field)) {
         return QVariant(dataType);
     }
-    const char* value = PQgetvalue(m_pResult, at(), i);
+    const char* value = PQgetvalue(m_pResult, row, field);
     switch (dataType) {
     case QVariant::Bool:
         return QVariant((bool)(value[0] == 't'));
@@ -77,41 +138,37 @@ QVariant KQPostgreSqlResult::data(int i)
         break;
     case QVariant::Double:
         if (typeOid == 1700) {
-            if (numericalPrecisionPolicy() != QSql::HighPrecision) {
-                QVariant retval;
-                bool convert;
-                double dbl=QString(value).toDouble(&convert);
-                if (numericalPrecisionPolicy() == QSql::LowPrecisionInt64)
-                    retval = (qlonglong)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionInt32)
-                    retval = (int)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionDouble)
-                    retval = dbl;
-                if (!convert)
-                    return QVariant();
-                return retval;
-            }
-            return QVariant(QString(value));
+            return numericValue(value, PQgetlength(m_pResult, row, field));
         }
-        return QVariant(QString(value).toDouble());
+        return QVariant(QByteArray::fromRawData(value, PQgetlength(m_pResult, row, field)).toDouble());
         break;
-    case QVariant::Date:
+    case QVariant::Date: {
+        QDate date;
+        if (KQPostgreSqlDateTime::parseDate(value, date)) {
+            return QVariant(date);
+        }
         return QVariant(QDate::fromString(QString(value), Qt::ISODate));
         break;
-    case QVariant::Time:
+    }
+    case QVariant::Time: {
+        QTime time;
+        if (KQPostgreSqlDateTime::parseTime(value, time)) {
+            return QVariant(time);
+        }
         return QVariant(QTime::fromString(QString(value), Qt::ISODate));
         break;
-    case QVariant::DateTime:
+    }
+    case QVariant::DateTime: {
+        QDateTime dateTime;
+        if (KQPostgreSqlDateTime::parseDateTime(value, dateTime)) {
+            return QVariant(dateTime);
+        }
         return QVariant(QDateTime::fromString(QString(value), Qt::ISODate));
         break;
-    case QVariant::ByteArray: {
-        size_t length = 0;
-        unsigned char* buffer = PQunescapeBytea((unsigned char*)value, &length);
-        QByteArray array((char*)buffer, length);
-        PQfreemem(buffer);
-        return QVariant(array);
-        break;
     }
+    case QVariant::ByteArray:
+        return QVariant(KQPostgreSqlBytea::decode(value, PQgetlength(m_pResult, row, field)));
+        break;
     default:
         qWarning("Unknown data type !");
         break;
@@ -120,6 +177,26 @@ QVariant KQPostgreSqlResult::data(int i)
     return QVariant();
 }
 
+/**
+ * Get a numeric value of the current row as fixed point decimal.
+ * No precision is lost. A NULL, a NaN or a number with more than
+ * 18 digits gives a zero decimal.
+ * @param i     Field number of a numeric field.
+ * @return      The value as decimal.
+ */
+KQPostgreSqlDecimal KQPostgreSqlResult::decimal(int i) const
+{
+    KQPostgreSqlDecimal decimal;
+    if (m_pResult == NULL || i >= PQnfields(m_pResult) || PQgetisnull(m_pResult, at(), i)) {
+        return decimal;
+    }
+    if (! KQPostgreSqlDecimal::parse(PQgetvalue(m_pResult, at(), i), decimal)) {
+        return KQPostgreSqlDecimal();
+    }
+
+    return decimal;
+}
+
 /**
  * Override
  * Lookup if a value in result is NULL.
@@ -153,7 +230,10 @@ bool KQPostgreSqlResult::reset(const QString &sqlquery)
 
 /**
  * Override
- * Sets the result to the given row.
+ * Sets the result to the given row. With row prefetch a row outside
+ * of the cache loads the block of the row. Blocks start at multiples
+ * of the prefetch count. So the block is reused if the query moves
+ * backward or seeks to rows nearby.
  * @param i     The number of where result should be set to.
  * @return      True if done.
  */
@@ -169,10 +249,58 @@ bool KQPostgreSqlResult::fetch(int i)
         return false;
     }
     setAt(i);
+    KQPostgreSqlDriver* pDriver = pgDriver();
+    int prefetch = pDriver ? pDriver->m_rowPrefetch : 0;
+    if (prefetch > 0 && (i < m_cacheFirstRow || i >= m_cacheFirstRow + m_cacheRows)) {
+        prefetchRows(i / prefetch * prefetch, prefetch);
+    }
 
     return true;
 }
 
+/**
+ * Private
+ * Decodes a block of rows into the row cache. The cache vector is
+ * reused for each block. Then data() only takes a value from the
+ * cache.
+ * @param firstRow      The first row of the block.
+ * @param count         The number of rows in the block.
+ */
+void KQPostgreSqlResult::prefetchRows(const int firstRow, const int count)
+{
+    int fieldCount = PQnfields(m_pResult);
+    int rowCount = qMin(count, PQntuples(m_pResult) - firstRow);
+    QVector<Oid> typeOids(fieldCount);
+    QVector<QVariant::Type> dataTypes(fieldCount);
+    for (int field=0; field<fieldCount; ++field) {
+        typeOids[field] = PQftype(m_pResult, field);
+        dataTypes[field] = variantTypeFromPostgreType(typeOids.at(field));
+    }
+    m_rowCache.resize(rowCount * fieldCount);
+    QVariant* pValue = m_rowCache.data();
+    for (int row=firstRow; row<firstRow + rowCount; ++row) {
+        for (int field=0; field<fieldCount; ++field) {
+            *pValue = decodeValue(row, field, typeOids.at(field), dataTypes.at(field));
+            ++pValue;
+        }
+    }
+    m_cacheFirstRow = firstRow;
+    m_cacheRows = rowCount;
+    m_cacheFields = fieldCount;
+}
+
+/**
+ * Private
+ * Invalidates the row cache. The memory of the cache is kept for
+ * the next block.
+ */
+void KQPostgreSqlResult::clearRowCache()
+{
+    m_cacheFirstRow = -1;
+    m_cacheRows = 0;
+    m_cacheFields = 0;
+}
+
 /**
  * Override
  * Sets the result to the first row.
@@ -261,32 +389,22 @@ QSqlRecord KQPostgreSqlResult::record() const
 bool KQPostgreSqlResult::prepare(const QString &query)
 {
     resetBindCount();
-    qDebug() << "Prepare: " << query;
-    bool ok = false;
-    QString stmt = replaceStandardPlaceholders(query, ok);
-    if (! ok) {
-        stmt = replaceNamedPlacholders(query, ok);
+    if (!driver()) {
+        return false;
     }
+    qDebug() << "Prepare: " << query;
+    QString stmt = statementText(query);
     qDebug() << "Placeholder replaced: " << stmt;
-    uint hash = qHash(query);
-    QString stmtName = QString::number(hash);
+    m_hasInsertId = needsReturningClause(query);
+    // A statement with RETURNING clause is another prepared statement.
+    QString stmtName = statementName(m_hasInsertId ? stmt : query);
     setQuery(stmtName);
+    m_statementText = stmt;
     if (isPrepared(stmtName)) {
         return true;
     }
-    PGconn* pConnection = driver()->handle().value<PGconn*>();
-    PGresult* result = PQprepare(pConnection, stmtName.toLocal8Bit().data(), stmt.toLocal8Bit().data(), boundValueCount(), NULL);
-    ExecStatusType statusType = PQresultStatus(result);
-    PQclear(result);
-    if (statusType != PGRES_COMMAND_OK) {
-        QString databaseErr(PQerrorMessage(pConnection));
-        QString code(PQresStatus(statusType));
-        QSqlError error(QString("Could not prepare SQL statement !"), databaseErr, QSqlError::StatementError,code);
-        setLastError(error);
-        return false;
-    }
 
-    return true;
+    return sendPrepare(stmtName, stmt);
 }
 
 /**
@@ -295,34 +413,97 @@ bool KQPostgreSqlResult::prepare(const QString &query)
  */
 bool KQPostgreSqlResult::exec()
 {
+    if (!driver()) {
+        return false;
+    }
     qDebug() << "exec(): " << lastQuery();
-    if (lastQuery().at(0).isDigit()) {
-        // Is a prepared statment.
-        executePreparedStmt();
-    } else {
-        // Is a SQL query.
-        PGconn* pConnection = driver()->handle().value<PGconn*>();
-        m_pResult = PQexec(pConnection, lastQuery().toLocal8Bit().data());
+    QElapsedTimer timer;
+    timer.start();
+    bool isPreparedStmt = lastQuery().at(0).isDigit();
+    if (! isPreparedStmt) {
+        m_hasInsertId = needsReturningClause(lastQuery());
     }
-    ExecStatusType status = PQresultStatus(m_pResult);
-    if (status == PGRES_TUPLES_OK) {
-        setActive(true);
-        setSelect(true);
-        m_currentSize = PQntuples(m_pResult);
-        return true;
+    PGconn* pConnection = execStatement(isPreparedStmt);
+    if (PQresultStatus(m_pResult) == PGRES_FATAL_ERROR && PQstatus(pConnection) == CONNECTION_BAD) {
+        // Connection is lost. Switch to another host and retry statements which do not modify data.
+        KQPostgreSqlDriver* pDriver = pgDriver();
+        bool isConnected = (pConnection != pDriver->connection()) || pDriver->failover();
+        QString statement = isPreparedStmt ? m_statementText : lastQuery();
+        if (isConnected && isReadOnlyStatement(statement)) {
+            if (isPreparedStmt && ! isPrepared(lastQuery())) {
+                sendPrepare(lastQuery(), m_statementText);
+            }
+            pConnection = execStatement(isPreparedStmt);
+        }
     }
-    if (status == PGRES_COMMAND_OK) {
-        setActive(true);
-        setSelect(false);
-        m_currentSize = -1;
-        return true;
+    if (isPreparedStmt && isStatementNameInvalid() && PQtransactionStatus(pConnection) == PQTRANS_IDLE) {
+        // The statement was deallocated on the server. Prepare it again and retry once.
+        pgDriver()->m_preparedNames.remove(lastQuery());
+        if (sendPrepare(lastQuery(), m_statementText)) {
+            pConnection = execStatement(isPreparedStmt);
+        }
     }
-    QSqlError error(QString("Could not execute query !"), QString(PQresultErrorMessage(m_pResult)), QSqlError::StatementError,
-                    QString(PQresStatus(status)));
-    setLastError(error);
-    clearResult();
+    if (! isPreparedStmt && isDeallocateStatement(lastQuery())) {
+        pgDriver()->m_preparedNames.clear();
+    }
+    qint64 elapsed = timer.nsecsElapsed() / 1000;
+    KQPostgreSqlStatistics* pStatistics = pgDriver()->m_pStatistics;
+    if (pStatistics) {
+        pStatistics->addExec(elapsed, m_pResult);
+    }
+    if (PQresultStatus(m_pResult) != PGRES_FATAL_ERROR) {
+        pgDriver()->addReadLatency(pConnection, elapsed);
+    }
+    if (PQresultStatus(m_pResult) == PGRES_TUPLES_OK && pgDriver()->isSlowQuerySample(elapsed)) {
+        explainStatement(pConnection, isPreparedStmt, elapsed);
+    }
+    updateMemoryAccount();
 
-    return false;
+    return applyResultStatus();
+}
+
+/**
+ * Override
+ * Switch to the next result of a multi statement query. The current
+ * result is discarded. All results were received by exec().
+ * @return      True if there is a next result without error.
+ */
+bool KQPostgreSqlResult::nextResult()
+{
+    if (m_pendingResults.isEmpty()) {
+        return false;
+    }
+    if (m_pResult) {
+        PQclear(m_pResult);
+    }
+    m_pResult = m_pendingResults.takeFirst();
+    setAt(QSql::BeforeFirstRow);
+    updateMemoryAccount();
+
+    return applyResultStatus();
+}
+
+/**
+ * Override
+ * Get the id of the row which was inserted by the last statement.
+ * The id is taken from the RETURNING clause which the driver adds to
+ * a single INSERT statement if this result has an insert id column.
+ * See KQPostgreSqlDriver::captureInsertId(). It is the first field of
+ * the first row. There is no id for a statement with its own RETURNING
+ * clause or with several statements.
+ * @return      The id or QVariant() if there is none.
+ */
+QVariant KQPostgreSqlResult::lastInsertId() const
+{
+    if (! m_hasInsertId || m_pResult == NULL || PQresultStatus(m_pResult) != PGRES_TUPLES_OK) {
+        return QVariant();
+    }
+    if (PQntuples(m_pResult) < 1 || PQnfields(m_pResult) < 1) {
+        return QVariant();
+    }
+    Oid typeOid = PQftype(m_pResult, 0);
+
+    return decodeValue(0, 0, typeOid, variantTypeFromPostgreType(typeOid));
 }
 
 /**
@@ -334,6 +515,44 @@ int KQPostgreSqlResult::size()
     return m_currentSize;
 }
 
+/**
+ * Private
+ * Converts the text of a numeric value as the numerical precision
+ * policy requires. HighPrecision keeps the text. The integer policies
+ * parse the text as decimal and cut off the fraction. Numbers which
+ * do not fit into a decimal are converted via double.
+ * @param value     The text of the numeric value.
+ * @param length    The length of the text.
+ * @return          The converted value. Or QVariant() if value is NaN.
+ */
+QVariant KQPostgreSqlResult::numericValue(const char *value, const int length) const
+{
+    QSql::NumericalPrecisionPolicy policy = numericalPrecisionPolicy();
+    if (policy == QSql::HighPrecision) {
+        return QVariant(QString(value));
+    }
+    KQPostgreSqlDecimal decimal;
+    if (policy != QSql::LowPrecisionDouble && KQPostgreSqlDecimal::parse(value, decimal)) {
+        if (policy == QSql::LowPrecisionInt32) {
+            return QVariant((int)decimal.toInt64());
+        }
+        return QVariant((qlonglong)decimal.toInt64());
+    }
+    bool convert = false;
+    double dbl = QByteArray::fromRawData(value, length).toDouble(&convert);
+    if (! convert) {
+        return QVariant();
+    }
+    if (policy == QSql::LowPrecisionInt64) {
+        return QVariant((qlonglong)dbl);
+    }
+    if (policy == QSql::LowPrecisionInt32) {
+        return QVariant((int)dbl);
+    }
+
+    return QVariant(dbl);
+}
+
 /**
  * Private
  * Get a QVariant type from a PostgreSql data type.
@@ -387,12 +606,70 @@ QVariant::Type KQPostgreSqlResult::variantTypeFromPostgreType(const Oid type) co
     return variantType;
 }
 
+/**
+ * Private
+ * Sets the state of this object from the status of the current result.
+ * A result with error is set as last error and deleted.
+ * @return      True if the current result has no error.
+ */
+bool KQPostgreSqlResult::applyResultStatus()
+{
+    clearRowCache();
+    if (m_isSizeLimitExceeded) {
+        QSqlError error(QString("Result exceeds the size limit !"),
+                        pgDriver() ? QString("Limit is %1 bytes.").arg(pgDriver()->m_resultSizeLimit) : QString(),
+                        QSqlError::StatementError);
+        setLastError(error);
+        clearResult();
+        return false;
+    }
+    if (m_isCopyRejected) {
+        QSqlError error(QString("COPY is not supported !"),
+                        QString("Use COPY with a file or a program instead of STDIN or STDOUT."),
+                        QSqlError::StatementError);
+        setLastError(error);
+        clearResult();
+        return false;
+    }
+    ExecStatusType status = PQresultStatus(m_pResult);
+    if (status == PGRES_TUPLES_OK && m_hasInsertId) {
+        // An INSERT with the RETURNING clause of the driver is no SELECT.
+        setActive(true);
+        setSelect(false);
+        m_currentSize = -1;
+        return true;
+    }
+    if (status == PGRES_TUPLES_OK) {
+        setActive(true);
+        setSelect(true);
+        m_currentSize = PQntuples(m_pResult);
+        return true;
+    }
+    if (status == PGRES_COMMAND_OK) {
+        setActive(true);
+        setSelect(false);
+        m_currentSize = -1;
+        return true;
+    }
+    QSqlError error(QString("Could not execute query !"), QString(PQresultErrorMessage(m_pResult)), QSqlError::StatementError,
+                    QString(PQresStatus(status)));
+    setLastError(error);
+    clearResult();
+
+    return false;
+}
+
 /**
  * Protected
- * Delete result from memory.
+ * Delete result from memory. Results of a multi statement query
+ * which were not taken by nextResult() are deleted too.
  */
 void KQPostgreSqlResult::clearResult()
 {
+    clearRowCache();
+    while (! m_pendingResults.isEmpty()) {
+        PQclear(m_pendingResults.takeFirst());
+    }
     if (m_pResult) {
         PQclear(m_pResult);
         m_pResult = NULL;
@@ -400,6 +677,21 @@ void KQPostgreSqlResult::clearResult()
         setActive(false);
         m_currentSize = -1;
     }
+    updateMemoryAccount();
+}
+
+/**
+ * Takes a result which was received by the driver. The result
+ * is deleted with this object. A result with error is set as
+ * last error.
+ * @param pResult       A result of the driver.
+ */
+void KQPostgreSqlResult::adoptResult(PGresult *pResult)
+{
+    clearResult();
+    m_pResult = pResult;
+    updateMemoryAccount();
+    applyResultStatus();
 }
 
 /**
@@ -577,20 +869,55 @@ QString KQPostgreSqlResult::variantToString(const QVariant &value) const
     return QString();
 }
 
+/**
+ * Private
+ * Builds the text of a statement which is to be prepared. Placeholders
+ * are replaced by PostgreSql placeholders ($1, $2, $3, ...). Named
+ * placeholders are bound to this result.
+ * @param query     The SQL query string with placeholders.
+ * @return          The statement text for PQprepare().
+ */
+QString KQPostgreSqlResult::statementText(const QString &query)
+{
+    bool ok = false;
+    QString stmt = replaceStandardPlaceholders(query, ok);
+    if (! ok) {
+        stmt = replaceNamedPlacholders(query, ok);
+    }
+
+    return withReturningClause(stmt);
+}
+
+/**
+ * Private
+ * The name of a prepared statement is the hash code of its query.
+ * @param query     The SQL query string with placeholders.
+ * @return          The statement name.
+ */
+QString KQPostgreSqlResult::statementName(const QString &query)
+{
+    return QString::number(qHash(query));
+}
+
 /**
  * Reads from PostgreSql view 'pg_prepared_statements' all known
  * prepared statements.
  * Prepared statements get names. These names are read from the view.
  * If the view of PostgreSql has stmtName than this statement was
  * prepared and can be executed.
+ * The driver keeps the names of statements prepared on the current
+ * primary connection. The view is read only for unknown names.
  * @param stmtName      The statement name to search for.
  * @return              True if statement is allready prepared.
  */
 bool KQPostgreSqlResult::isPrepared(const QString &stmtName) const
 {
+    KQPostgreSqlDriver* pDriver = pgDriver();
+    if (pDriver->m_preparedNames.contains(stmtName)) {
+        return true;
+    }
     bool isStmtPrepared = false;
-    QVariant connectionHandle = driver()->handle();
-    PGconn* pConnection = connectionHandle.value<PGconn*>();
+    PGconn* pConnection = pDriver->connection();
     char* sqlSelect = "SELECT name FROM pg_prepared_statements";
     PGresult* result = PQexec(pConnection, sqlSelect);
     if (PQresultStatus(result) == PGRES_TUPLES_OK) {
@@ -600,6 +927,7 @@ bool KQPostgreSqlResult::isPrepared(const QString &stmtName) const
             QString preparedStmtName(value);
             if (stmtName == preparedStmtName) {
                 isStmtPrepared = true;
+                pDriver->m_preparedNames.insert(stmtName);
                 break;
             }
         }
@@ -611,11 +939,10 @@ bool KQPostgreSqlResult::isPrepared(const QString &stmtName) const
 
 /**
  * Execute a SQL statement which is allready prepared.
- * @return
+ * @param pConnection       The connection where the statement is prepared.
  */
-void KQPostgreSqlResult::executePreparedStmt()
+void KQPostgreSqlResult::executePreparedStmt(PGconn *pConnection)
 {
-    clearResult();
     QVector<QVariant> paramVector = boundValues();
     qDebug() << "Values: " << paramVector;
     // Allocate memory for bind values.
@@ -626,9 +953,508 @@ void KQPostgreSqlResult::executePreparedStmt()
         values[index] = stringCopy(value);
         valueLength[index] = value.length();
     }
-    PGconn* pConnection = driver()->handle().value<PGconn*>();
-    m_pResult = PQexecPrepared(pConnection, lastQuery().toLocal8Bit().data(), boundValueCount(), values, valueLength, NULL, 0);
+    int isSent = PQsendQueryPrepared(pConnection, lastQuery().toLocal8Bit().data(), boundValueCount(), values, valueLength, NULL, 0);
     // Free allocated memory.
     freeCStringArray(values, paramVector.size());
     delete[] valueLength;
+    if (isSent == 0) {
+        m_pResult = PQmakeEmptyPGresult(pConnection, PGRES_FATAL_ERROR);
+        return;
+    }
+    receiveResults(pConnection);
+}
+
+/**
+ * Private
+ * Executes the current query. A prepared statement is executed on
+ * the primary connection. It exists on the primary only and is never
+ * routed to a replica, even if it is a SELECT. Read only SQL statements
+ * are routed by the driver. All other statements go to the primary
+ * connection.
+ * @param isPreparedStmt    True if the query is the name of a prepared statement.
+ * @return                  The connection which executed the statement.
+ */
+PGconn *KQPostgreSqlResult::execStatement(const bool isPreparedStmt)
+{
+    clearResult();
+    KQPostgreSqlDriver* pDriver = pgDriver();
+    if (isPreparedStmt) {
+        PGconn* pConnection = pDriver->connection();
+        executePreparedStmt(pConnection);
+        return pConnection;
+    }
+    PGconn* pConnection = NULL;
+    if (isReadOnlyStatement(lastQuery())) {
+        pConnection = pDriver->readConnection();
+    } else {
+        pConnection = pDriver->connection();
+    }
+    QString statement = withReturningClause(lastQuery());
+    if (PQsendQuery(pConnection, statement.toLocal8Bit().data()) == 0) {
+        m_pResult = PQmakeEmptyPGresult(pConnection, PGRES_FATAL_ERROR);
+        return pConnection;
+    }
+    receiveResults(pConnection);
+
+    return pConnection;
+}
+
+/**
+ * Private
+ * Executes a statement with parameters on the primary connection. The
+ * parameters are sent in text format. Is used by the driver for
+ * statements which it builds itself.
+ * @param statement     The SQL statement with PostgreSql placeholders ($1, $2, ...).
+ * @param parameters    The text of the parameters. Same order as the placeholders.
+ * @return              True if done.
+ */
+bool KQPostgreSqlResult::execParams(const QString &statement, const QVector<QByteArray> &parameters)
+{
+    QElapsedTimer timer;
+    timer.start();
+    setQuery(statement);
+    m_hasInsertId = false;
+    clearResult();
+    KQPostgreSqlDriver* pDriver = pgDriver();
+    PGconn* pConnection = pDriver->connection();
+    QVector<const char*> values(parameters.size());
+    for (int index=0; index<parameters.size(); ++index) {
+        values[index] = parameters.at(index).constData();
+    }
+    if (PQsendQueryParams(pConnection, statement.toUtf8().constData(), values.size(), NULL, values.data(),
+                          NULL, NULL, 0) == 0) {
+        m_pResult = PQmakeEmptyPGresult(pConnection, PGRES_FATAL_ERROR);
+    } else {
+        receiveResults(pConnection);
+    }
+    qint64 elapsed = timer.nsecsElapsed() / 1000;
+    if (pDriver->m_pStatistics) {
+        pDriver->m_pStatistics->addExec(elapsed, m_pResult);
+    }
+    updateMemoryAccount();
+
+    return applyResultStatus();
+}
+
+/**
+ * Private
+ * Receives all results of a query which was sent with PQsendQuery().
+ * A query with several statements returns one result for each statement.
+ * The first result becomes the current result. The others are kept
+ * for nextResult(). If a statement fails then the failed result is
+ * the current result and all others are deleted.
+ * If the driver has a result size limit then the memory of each result
+ * is checked as soon as it is received. If the results together exceed the limit
+ * the rest of the query is canceled and all results are deleted. This
+ * fails fast but does not stream. A single result is received as a whole
+ * before it is checked. So the limit bounds the memory which a result
+ * holds afterwards, not the peak while it is received. Use a cursor to
+ * read a large table in parts.
+ * COPY FROM STDIN and COPY TO STDOUT are rejected. The copy is ended
+ * and the rest of the query is canceled.
+ * @param pConnection       The connection which executes the query.
+ */
+void KQPostgreSqlResult::receiveResults(PGconn *pConnection)
+{
+    qint64 sizeLimit = pgDriver()->m_resultSizeLimit;
+    m_isSizeLimitExceeded = false;
+    m_isCopyRejected = false;
+    qint64 receivedBytes = 0;
+    PGresult* result = PQgetResult(pConnection);
+    while (result != NULL) {
+        ExecStatusType status = PQresultStatus(result);
+        if (m_isSizeLimitExceeded || m_isCopyRejected) {
+            PQclear(result);
+        } else if (status == PGRES_COPY_IN || status == PGRES_COPY_OUT || status == PGRES_COPY_BOTH) {
+            // The connection stays in copy state until the copy is ended.
+            PQclear(result);
+            if (status != PGRES_COPY_IN) {
+                cancelQuery(pConnection);
+            }
+            endCopy(pConnection, status);
+            clearResult();
+            m_isCopyRejected = true;
+        } else {
+            receivedBytes += (qint64)PQresultMemorySize(result);
+            if (sizeLimit > 0 && receivedBytes > sizeLimit) {
+                PQclear(result);
+                cancelQuery(pConnection);
+                clearResult();
+                m_isSizeLimitExceeded = true;
+            } else {
+                takeResult(result);
+            }
+        }
+        result = PQgetResult(pConnection);
+    }
+    if (m_pResult == NULL) {
+        m_pResult = PQmakeEmptyPGresult(pConnection, PGRES_FATAL_ERROR);
+    }
+}
+
+/**
+ * Private
+ * Takes a received result. The first result becomes the current
+ * result. Further results are kept for nextResult(). A failed result
+ * replaces all other results.
+ * @param result        A received result.
+ */
+void KQPostgreSqlResult::takeResult(PGresult *result)
+{
+    ExecStatusType status = PQresultStatus(result);
+    if (status == PGRES_FATAL_ERROR || status == PGRES_BAD_RESPONSE) {
+        clearResult();
+        m_pResult = result;
+    } else if (m_pResult == NULL) {
+        m_pResult = result;
+    } else if (PQresultStatus(m_pResult) == PGRES_FATAL_ERROR || PQresultStatus(m_pResult) == PGRES_BAD_RESPONSE) {
+        PQclear(result);
+    } else {
+        m_pendingResults.append(result);
+    }
+}
+
+/**
+ * Private
+ * Requests the server to cancel the running query.
+ * @param pConnection       The connection which executes the query.
+ */
+void KQPostgreSqlResult::cancelQuery(PGconn *pConnection) const
+{
+    PGcancel* pCancel = PQgetCancel(pConnection);
+    if (pCancel == NULL) {
+        return;
+    }
+    char errorBuffer[256];
+    PQcancel(pCancel, errorBuffer, sizeof(errorBuffer));
+    PQfreeCancel(pCancel);
+}
+
+/**
+ * Private
+ * Ends a copy which was started by a COPY statement. The data of
+ * COPY TO STDOUT is discarded. COPY FROM STDIN is ended with an error.
+ * The server does not change the table then.
+ * @param pConnection       The connection in copy state.
+ * @param status            The status of the copy result.
+ */
+void KQPostgreSqlResult::endCopy(PGconn *pConnection, const ExecStatusType status) const
+{
+    if (status == PGRES_COPY_IN || status == PGRES_COPY_BOTH) {
+        PQputCopyEnd(pConnection, "COPY is not supported by the driver");
+    }
+    if (status == PGRES_COPY_OUT || status == PGRES_COPY_BOTH) {
+        char* buffer = NULL;
+        while (PQgetCopyData(pConnection, &buffer, 0) > 0) {
+            PQfreemem(buffer);
+        }
+    }
+}
+
+/**
+ * Private
+ * Accounts the memory of all results held by this object at the
+ * driver. Must be called whenever results are taken or deleted.
+ */
+void KQPostgreSqlResult::updateMemoryAccount()
+{
+    qint64 bytes = 0;
+    if (m_pResult) {
+        bytes += (qint64)PQresultMemorySize(m_pResult);
+    }
+    foreach (const PGresult* result, m_pendingResults) {
+        bytes += (qint64)PQresultMemorySize(result);
+    }
+    if (bytes != m_heldBytes) {
+        KQPostgreSqlDriver* pDriver = pgDriver();
+        if (pDriver) {
+            pDriver->addResultBytes(bytes - m_heldBytes);
+        } else {
+            // The driver was deleted before this result.
+            KQPostgreSqlDriver::addProcessResultBytes(bytes - m_heldBytes);
+        }
+        m_heldBytes = bytes;
+    }
+}
+
+/**
+ * Private
+ * Send a statement to the server to prepare it.
+ * @param stmtName      The name of the prepared statement.
+ * @param stmt          The statement with PostgreSql placeholders.
+ * @return              True if successfully prepared.
+ */
+bool KQPostgreSqlResult::sendPrepare(const QString &stmtName, const QString &stmt)
+{
+    QElapsedTimer timer;
+    timer.start();
+    PGconn* pConnection = pgDriver()->connection();
+    PGresult* result = PQprepare(pConnection, stmtName.toLocal8Bit().data(), stmt.toLocal8Bit().data(), boundValueCount(), NULL);
+    ExecStatusType statusType = PQresultStatus(result);
+    PQclear(result);
+    KQPostgreSqlStatistics* pStatistics = pgDriver()->m_pStatistics;
+    if (pStatistics) {
+        pStatistics->addPrepare(timer.nsecsElapsed() / 1000);
+    }
+    if (statusType != PGRES_COMMAND_OK) {
+        QString databaseErr(PQerrorMessage(pConnection));
+        QString code(PQresStatus(statusType));
+        QSqlError error(QString("Could not prepare SQL statement !"), databaseErr, QSqlError::StatementError,code);
+        setLastError(error);
+        return false;
+    }
+    pgDriver()->m_preparedNames.insert(stmtName);
+
+    return true;
+}
+
+/**
+ * Private
+ * Tests if a statement only reads data. Such a statement can be
+ * executed by a replica. A SELECT with a locking clause or with
+ * INTO is not read only.
+ * @param statement     A SQL statement.
+ * @return              True if statement is read only.
+ */
+bool KQPostgreSqlResult::isReadOnlyStatement(const QString &statement) const
+{
+    static const QRegularExpression modifyingClause("\\binto\\b|\\bfor\\s+(no\\s+key\\s+update|update|key\\s+share|share)\\b",
+                                                    QRegularExpression::CaseInsensitiveOption);
+    QString stmt = statement.trimmed();
+    if (! stmt.startsWith(QString("select"), Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    return ! modifyingClause.match(stmt).hasMatch();
+}
+
+/**
+ * Private
+ * Explains a slow statement with EXPLAIN (FORMAT JSON). The plan is
+ * added to the statistics of the driver. The statement is not executed
+ * again, so the plan has estimates but no actual times. A statement in
+ * a transaction block is not explained. EXPLAIN would fail in an aborted
+ * transaction and hold its locks until the end of the transaction.
+ * A prepared statement is explained with its bound values.
+ * @param pConnection       The connection which executed the statement.
+ * @param isPreparedStmt    True if the query is the name of a prepared statement.
+ * @param microseconds      The time to execute the statement.
+ */
+void KQPostgreSqlResult::explainStatement(PGconn *pConnection, const bool isPreparedStmt, const qint64 microseconds)
+{
+    if (PQtransactionStatus(pConnection) != PQTRANS_IDLE) {
+        return;
+    }
+    QString statement = isPreparedStmt ? m_statementText : lastQuery();
+    QByteArray explain = QString("EXPLAIN (FORMAT JSON) ").append(statement).toLocal8Bit();
+    QVector<QByteArray> parameters;
+    QVector<const char*> values;
+    if (isPreparedStmt) {
+        QVector<QVariant> paramVector = boundValues();
+        parameters.reserve(paramVector.size());
+        foreach (const QVariant& value, paramVector) {
+            parameters.append(variantToString(value).toLocal8Bit());
+            values.append(value.isNull() ? NULL : parameters.last().constData());
+        }
+    }
+    PGresult* result = PQexecParams(pConnection, explain.constData(), values.size(), NULL, values.data(), NULL, NULL, 0);
+    QJsonValue plan;
+    if (PQresultStatus(result) == PGRES_TUPLES_OK && PQntuples(result) > 0) {
+        plan = QJsonDocument::fromJson(QByteArray(PQgetvalue(result, 0, 0))).array();
+    }
+    PQclear(result);
+    pgDriver()->m_pStatistics->addSlowQuery(qHash(statement), statement, microseconds, plan);
+}
+
+/**
+ * Private
+ * Tests if a statement is an INSERT statement.
+ * @param statement     A SQL statement.
+ * @return              True if statement is an INSERT.
+ */
+bool KQPostgreSqlResult::isInsertStatement(const QString &statement) const
+{
+    return statement.trimmed().startsWith(QString("insert"), Qt::CaseInsensitive);
+}
+
+/**
+ * Private
+ * Tests if a statement deallocates prepared statements. DEALLOCATE and
+ * DISCARD ALL remove prepared statements from the server. The names
+ * which the driver knows as prepared are outdated then.
+ * @param statement     A SQL statement.
+ * @return              True if statement has DEALLOCATE or DISCARD ALL.
+ */
+bool KQPostgreSqlResult::isDeallocateStatement(const QString &statement) const
+{
+    static const QRegularExpression deallocate("\\bdeallocate\\b|\\bdiscard\\s+all\\b",
+                                               QRegularExpression::CaseInsensitiveOption);
+
+    return deallocate.match(statement).hasMatch();
+}
+
+/**
+ * Private
+ * Tests if the current result failed because a prepared statement
+ * does not exist on the server (SQLSTATE 26000).
+ * @return              True if the prepared statement is unknown.
+ */
+bool KQPostgreSqlResult::isStatementNameInvalid() const
+{
+    if (PQresultStatus(m_pResult) != PGRES_FATAL_ERROR) {
+        return false;
+    }
+    const char* sqlState = PQresultErrorField(m_pResult, PG_DIAG_SQLSTATE);
+
+    return sqlState != NULL && strcmp(sqlState, "26000") == 0;
+}
+
+/**
+ * Private
+ * Tests if the driver adds a RETURNING clause to a statement. This is
+ * done only if the caller set an insert id column for this result. The
+ * statement must be a single INSERT statement without a RETURNING
+ * clause. Literals, quoted identifiers and comments are not searched.
+ * @param statement     A SQL statement.
+ * @return              True if the statement gets a RETURNING clause.
+ */
+bool KQPostgreSqlResult::needsReturningClause(const QString &statement) const
+{
+    static const QRegularExpression returningClause("\\breturning\\b", QRegularExpression::CaseInsensitiveOption);
+    if (m_insertIdColumn.isEmpty()) {
+        return false;
+    }
+    QString masked = maskQuotedText(statement);
+    masked.truncate(statementEnd(masked));
+    if (! isInsertStatement(masked) || masked.contains(QChar(';'))) {
+        return false;
+    }
+
+    return ! returningClause.match(masked).hasMatch();
+}
+
+/**
+ * Private
+ * Adds a RETURNING clause with the insert id column of this result
+ * to a single INSERT statement. All other statements are not changed.
+ * A ';' and a comment at the end of the statement are removed.
+ * @param statement     A SQL statement.
+ * @return              The statement with RETURNING clause.
+ */
+QString KQPostgreSqlResult::withReturningClause(const QString &statement) const
+{
+    if (! needsReturningClause(statement)) {
+        return statement;
+    }
+
+    return statement.left(statementEnd(maskQuotedText(statement))).append(QString(" RETURNING ")).append(m_insertIdColumn);
+}
+
+/**
+ * Private
+ * Replaces string literals, quoted identifiers, dollar quoted strings
+ * and comments of a statement with blanks. Keywords and ';' outside of
+ * them keep their positions.
+ * @param statement     A SQL statement.
+ * @return              The statement with blanks instead of quoted text.
+ */
+QString KQPostgreSqlResult::maskQuotedText(const QString &statement)
+{
+    static const QRegularExpression dollarTag("\\$([A-Za-z_][A-Za-z_0-9]*)?\\$");
+    QString masked = statement;
+    int length = statement.length();
+    int position = 0;
+    while (position < length) {
+        QChar character = statement.at(position);
+        QChar nextCharacter = position + 1 < length ? statement.at(position + 1) : QChar();
+        bool isWordStart = position == 0 || ! (statement.at(position - 1).isLetterOrNumber() ||
+                                               statement.at(position - 1) == QChar('_'));
+        int end = position;
+        if (character == QChar('\'') || character == QChar('"')) {
+            // E'...' strings have backslash escapes. A doubled quote is a quote.
+            bool hasEscapes = character == QChar('\'') && position > 0 && statement.at(position - 1).toLower() == QChar('e');
+            end = position + 1;
+            while (end < length) {
+                if (hasEscapes && statement.at(end) == QChar('\\')) {
+                    end += 2;
+                    continue;
+                }
+                if (statement.at(end) == character) {
+                    if (end + 1 < length && statement.at(end + 1) == character) {
+                        end += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++end;
+            }
+            end = qMin(end + 1, length);
+        } else if (character == QChar('-') && nextCharacter == QChar('-')) {
+            end = statement.indexOf(QChar('\n'), position);
+            if (end < 0) {
+                end = length;
+            }
+        } else if (character == QChar('/') && nextCharacter == QChar('*')) {
+            // Block comments can be nested.
+            int depth = 0;
+            end = position;
+            while (end < length) {
+                if (statement.midRef(end, 2) == QLatin1String("/*")) {
+                    ++depth;
+                    end += 2;
+                } else if (statement.midRef(end, 2) == QLatin1String("*/")) {
+                    end += 2;
+                    if (--depth == 0) {
+                        break;
+                    }
+                } else {
+                    ++end;
+                }
+            }
+            end = qMin(end, length);
+        } else if (character == QChar('$') && isWordStart) {
+            QRegularExpressionMatch match = dollarTag.match(statement, position, QRegularExpression::NormalMatch,
+                                                            QRegularExpression::AnchoredMatchOption);
+            if (match.hasMatch()) {
+                QString tag = match.captured(0);
+                int closing = statement.indexOf(tag, position + tag.length());
+                end = closing < 0 ? length : closing + tag.length();
+            }
+        }
+        if (end == position) {
+            ++position;
+            continue;
+        }
+        masked.replace(position, end - position, QString(end - position, QChar(' ')));
+        position = end;
+    }
+
+    return masked;
+}
+
+/**
+ * Private
+ * Finds the end of a statement without blanks and ';' at its end.
+ * @param maskedStatement   A statement from maskQuotedText().
+ * @return                  The length of the statement without its end.
+ */
+int KQPostgreSqlResult::statementEnd(const QString &maskedStatement)
+{
+    int end = maskedStatement.length();
+    while (end > 0 && (maskedStatement.at(end - 1).isSpace() || maskedStatement.at(end - 1) == QChar(';'))) {
+        --end;
+    }
+
+    return end;
+}
+
+/**
+ * Private
+ * The driver of this result.
+ * @return          Pointer to the KQPostgreSqlDriver object. NULL if the
+ *                  driver was deleted before this result.
+ */
+KQPostgreSqlDriver *KQPostgreSqlResult::pgDriver() const
+{
+    return const_cast<KQPostgreSqlDriver*>(static_cast<const KQPostgreSqlDriver*>(driver()));
 }
@@ -2,7 +2,11 @@
 #define KQPOSTGRESQLRESULT_H
 
 #include "kqpostgresqldriver.h"
+#include "kqpostgresqlcolumn.h"
+#include "kqpostgresqldecimal.h"
 #include <QSqlResult>
+#include <QVector>
+#include <QList>
 
 
 class KQPostgreSqlResult : public QSqlResult
@@ -12,6 +16,10 @@ public:
     ~KQPostgreSqlResult();
 
     QVariant handle() const override;
+    QVector<KQPostgreSqlColumn> columns() const;
+    KQPostgreSqlDecimal decimal(int i) const;
+    void setInsertIdColumn(const QString& column)           { m_insertIdColumn = column; }
+    QString insertIdColumn() const                          { return m_insertIdColumn; }
 
 protected:
     explicit KQPostgreSqlResult(const QSqlDriver* driver);
@@ -27,10 +35,19 @@ protected:
     bool prepare(const QString &query) override;
     bool exec() override;
     int size() override;
+    bool nextResult() override;
+    QVariant lastInsertId() const override;
 
 private:
     // Concret class members
     void clearResult();
+    void adoptResult(PGresult* pResult);
+    bool applyResultStatus();
+    void receiveResults(PGconn* pConnection);
+    void takeResult(PGresult* result);
+    void cancelQuery(PGconn* pConnection) const;
+    void endCopy(PGconn* pConnection, const ExecStatusType status) const;
+    void updateMemoryAccount();
     QString replaceStandardPlaceholders(QString sqlStatement, bool &ok) const;
     QString replaceNamedPlacholders(QString sqlStatement, bool& ok);
     QString replacePlaceholder(QString &sqlStatement, const int startPos, const QString &placeholder);
@@ -38,13 +55,43 @@ private:
     void freeCStringArray(char** array, const int size);
     char* stringCopy(const QString& origin) const;
     QString variantToString(const QVariant& value) const;
+    QString statementText(const QString& query);
+    static QString statementName(const QString& query);
     bool isPrepared(const QString& stmtName) const;
-    void executePreparedStmt();
+    void executePreparedStmt(PGconn* pConnection);
+    PGconn* execStatement(const bool isPreparedStmt);
+    bool execParams(const QString& statement, const QVector<QByteArray>& parameters);
+    bool sendPrepare(const QString& stmtName, const QString& stmt);
+    bool isReadOnlyStatement(const QString& statement) const;
+    bool isInsertStatement(const QString& statement) const;
+    bool isDeallocateStatement(const QString& statement) const;
+    bool isStatementNameInvalid() const;
+    void explainStatement(PGconn* pConnection, const bool isPreparedStmt, const qint64 microseconds);
+    bool needsReturningClause(const QString& statement) const;
+    QString withReturningClause(const QString& statement) const;
+    static QString maskQuotedText(const QString& statement);
+    static int statementEnd(const QString& maskedStatement);
+    KQPostgreSqlDriver* pgDriver() const;
     QVariant::Type variantTypeFromPostgreType(const Oid type) const;
+    QVariant numericValue(const char* value, const int length) const;
+    QVariant decodeValue(const int row, const int field, const Oid typeOid, const QVariant::Type dataType) const;
+    void prefetchRows(const int firstRow, const int count);
+    void clearRowCache();
 
 private:
     PGresult* m_pResult;
+    QList<PGresult*> m_pendingResults;
     int m_currentSize;
+    QString m_statementText;
+    QVector<QVariant> m_rowCache;
+    int m_cacheFirstRow;
+    int m_cacheRows;
+    int m_cacheFields;
+    qint64 m_heldBytes;
+    bool m_isSizeLimitExceeded;
+    bool m_isCopyRejected;
+    bool m_hasInsertId;
+    QString m_insertIdColumn;
 };
 
 #endif // KQPOSTGRESQLRESULT_H
@@ -0,0 +1,111 @@
+#include "kqpostgresqlstatistics.h"
+
+
+/**
+ * Constructor
+ * All counters are zero.
+ */
+KQPostgreSqlStatistics::KQPostgreSqlStatistics()
+{
+    reset();
+}
+
+/**
+ * Sets all counters to zero.
+ */
+void KQPostgreSqlStatistics::reset()
+{
+    m_connectCount = 0;
+    m_connectTime = 0;
+    m_prepareCount = 0;
+    m_prepareTime = 0;
+    m_execCount = 0;
+    m_execTime = 0;
+    m_rowCount = 0;
+    m_resultBytes = 0;
+    m_decodeCount.clear();
+    m_slowQueries = QJsonArray();
+}
+
+/**
+ * Count a connection.
+ * @param microseconds      The time to open the connection.
+ */
+void KQPostgreSqlStatistics::addConnect(const qint64 microseconds)
+{
+    ++m_connectCount;
+    m_connectTime += microseconds;
+}
+
+/**
+ * Count a prepared statement.
+ * @param microseconds      The time to prepare the statement.
+ */
+void KQPostgreSqlStatistics::addPrepare(const qint64 microseconds)
+{
+    ++m_prepareCount;
+    m_prepareTime += microseconds;
+}
+
+/**
+ * Count an executed statement and the rows of its result.
+ * @param microseconds      The time to execute the statement and receive the result.
+ * @param pResult           The result of the statement. Can be NULL.
+ */
+void KQPostgreSqlStatistics::addExec(const qint64 microseconds, const PGresult *pResult)
+{
+    ++m_execCount;
+    m_execTime += microseconds;
+    if (pResult && PQresultStatus(pResult) == PGRES_TUPLES_OK) {
+        m_rowCount += PQntuples(pResult);
+        m_resultBytes += PQresultMemorySize(pResult);
+    }
+}
+
+/**
+ * Keeps a sampled slow query. Only the last 32 slow queries are kept.
+ * @param hash              The hash of the statement.
+ * @param statement         The SQL statement.
+ * @param microseconds      The time to execute the statement.
+ * @param plan              The JSON plan of the statement. Null if it could not be explained.
+ */
+void KQPostgreSqlStatistics::addSlowQuery(const uint hash, const QString &statement, const qint64 microseconds,
+                                          const QJsonValue &plan)
+{
+    QJsonObject slowQuery;
+    slowQuery.insert(QString("hash"), QString::number(hash));
+    slowQuery.insert(QString("statement"), statement);
+    slowQuery.insert(QString("time"), microseconds);
+    slowQuery.insert(QString("plan"), plan);
+    if (m_slowQueries.size() >= 32) {
+        m_slowQueries.removeFirst();
+    }
+    m_slowQueries.append(slowQuery);
+}
+
+/**
+ * Get all counters in a JSON object.
+ * Decode counters are in an object 'decode' with the type Oid as key.
+ * @return      A JSON object with all counters.
+ */
+QJsonObject KQPostgreSqlStatistics::toJson() const
+{
+    QJsonObject decode;
+    QHash<Oid, quint64>::const_iterator iterator;
+    for (iterator = m_decodeCount.constBegin(); iterator != m_decodeCount.constEnd(); ++iterator) {
+        decode.insert(QString::number(iterator.key()), (qint64)iterator.value());
+    }
+    QJsonObject object;
+    object.insert(QString("connectCount"), (qint64)m_connectCount);
+    object.insert(QString("connectTime"), m_connectTime);
+    object.insert(QString("prepareCount"), (qint64)m_prepareCount);
+    object.insert(QString("prepareTime"), m_prepareTime);
+    object.insert(QString("execCount"), (qint64)m_execCount);
+    object.insert(QString("execTime"), m_execTime);
+    object.insert(QString("rowCount"), (qint64)m_rowCount);
+    object.insert(QString("resultBytes"), (qint64)m_resultBytes);
+    object.insert(QString("decode"), decode);
+    object.insert(QString("slowQueries"), m_slowQueries);
+
+    return object;
+}
@@ -0,0 +1,68 @@
+#ifndef KQPOSTGRESQLSTATISTICS_H
+#define KQPOSTGRESQLSTATISTICS_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlStatistics
+ * -------------------------------------------------------------------------------------
+ * Counters for the hot paths of the driver. The driver collects them while
+ * statistics are enabled (KQPostgreSqlDriver::setStatisticsEnabled()).
+ *
+ * connect      Number of connections and the time to open them.
+ * prepare      Number of PQprepare() calls and their time.
+ * exec         Number of executed statements and their time.
+ * rows         Rows received and the memory of their results. Gives the
+ *              memory per fetched row.
+ * decode       Number of values decoded by data() for each PostgreSql type.
+ * slowQueries  The last sampled slow queries with statement hash, time and
+ *              the plan of EXPLAIN (FORMAT JSON). The plan has estimates only.
+ *
+ * All times are in microseconds. toJson() returns all counters as a JSON
+ * object. The benchmark in Benchmark/ stores them with its cases.
+ */
+
+#include <libpq-fe.h>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonArray>
+
+
+class KQPostgreSqlStatistics
+{
+public:
+    KQPostgreSqlStatistics();
+
+    void reset();
+    void addConnect(const qint64 microseconds);
+    void addPrepare(const qint64 microseconds);
+    void addExec(const qint64 microseconds, const PGresult* pResult);
+    void addDecode(const Oid type)                      { ++m_decodeCount[type]; }
+    void addSlowQuery(const uint hash, const QString& statement, const qint64 microseconds, const QJsonValue& plan);
+
+    quint64 connectCount() const                        { return m_connectCount; }
+    qint64 connectTime() const                          { return m_connectTime; }
+    quint64 prepareCount() const                        { return m_prepareCount; }
+    qint64 prepareTime() const                          { return m_prepareTime; }
+    quint64 execCount() const                           { return m_execCount; }
+    qint64 execTime() const                             { return m_execTime; }
+    quint64 rowCount() const                            { return m_rowCount; }
+    quint64 resultBytes() const                         { return m_resultBytes; }
+    quint64 decodeCount(const Oid type) const           { return m_decodeCount.value(type, 0); }
+    QJsonArray slowQueries() const                      { return m_slowQueries; }
+
+    QJsonObject toJson() const;
+
+private:
+    quint64 m_connectCount;
+    qint64 m_connectTime;
+    quint64 m_prepareCount;
+    qint64 m_prepareTime;
+    quint64 m_execCount;
+    qint64 m_execTime;
+    quint64 m_rowCount;
+    quint64 m_resultBytes;
+    QHash<Oid, quint64> m_decodeCount;
+    QJsonArray m_slowQueries;
+};
+
+#endif // KQPOSTGRESQLSTATISTICS_H
@@ -0,0 +1,149 @@
+#include "kqpostgresqlsyntheticresult.h"
+
+
+/**
+ * Constructor
+ * A result shape without columns and without NULL values.
+ * @param rows      The number of rows of the result.
+ */
+KQPostgreSqlSyntheticResult::KQPostgreSqlSyntheticResult(const int rows) :
+    m_rows(rows),
+    m_nullRatio(0.0),
+    m_seed(1)
+{
+
+}
+
+/**
+ * Adds a column to the result.
+ * @param name      The column name.
+ * @param type      The PostgreSql type Oid of the column.
+ */
+void KQPostgreSqlSyntheticResult::addColumn(const QString &name, const Oid type)
+{
+    m_columnNames.append(name.toUtf8());
+    m_columnTypes.append(type);
+}
+
+/**
+ * Creates a PGresult with generated values. The result must be
+ * deleted with PQclear() or handed to the driver.
+ * @return      A result with status PGRES_TUPLES_OK or NULL.
+ */
+PGresult *KQPostgreSqlSyntheticResult::create() const
+{
+    PGresult* pResult = PQmakeEmptyPGresult(NULL, PGRES_TUPLES_OK);
+    if (pResult == NULL) {
+        return NULL;
+    }
+    int columnCount = m_columnTypes.size();
+    QVector<PGresAttDesc> attributes(columnCount);
+    for (int column=0; column<columnCount; ++column) {
+        PGresAttDesc& attribute = attributes[column];
+        attribute.name = const_cast<char*>(m_columnNames.at(column).constData());
+        attribute.tableid = 0;
+        attribute.columnid = 0;
+        attribute.format = 0;
+        attribute.typid = m_columnTypes.at(column);
+        attribute.typlen = -1;
+        attribute.atttypmod = -1;
+    }
+    if (PQsetResultAttrs(pResult, columnCount, attributes.data()) == 0) {
+        PQclear(pResult);
+        return NULL;
+    }
+    quint32 state = m_seed;
+    quint32 nullLimit = (quint32)(m_nullRatio * 4294967295.0);
+    for (int row=0; row<m_rows; ++row) {
+        for (int column=0; column<columnCount; ++column) {
+            if (m_nullRatio > 0.0 && nextRandom(state) <= nullLimit) {
+                PQsetvalue(pResult, row, column, NULL, -1);
+                continue;
+            }
+            QByteArray value = valueOfType(m_columnTypes.at(column), row, state);
+            PQsetvalue(pResult, row, column, value.data(), value.length());
+        }
+    }
+
+    return pResult;
+}
+
+/**
+ * Private
+ * A simple linear congruential generator. Is used instead of qrand()
+ * to keep results independent from other random numbers.
+ * @param state     The state of the generator.
+ * @return          The next random number.
+ */
+quint32 KQPostgreSqlSyntheticResult::nextRandom(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+
+    return state;
+}
+
+/**
+ * Private
+ * Generates a value of a PostgreSql type in text format.
+ * @param type      The PostgreSql type Oid.
+ * @param row       The row number.
+ * @param state     The state of the random generator.
+ * @return          The value as it is sent by the server.
+ */
+QByteArray KQPostgreSqlSyntheticResult::valueOfType(const Oid type, const int row, quint32 &state)
+{
+    quint32 random = nextRandom(state);
+    switch (type) {
+    case 16:        // bool
+        return QByteArray((random & 1) ? "t" : "f");
+        break;
+    case 21:        // int2
+        return QByteArray::number((int)(random % 65536) - 32768);
+        break;
+    case 23:        // int4
+        return QByteArray::number((qint32)random);
+        break;
+    case 20:        // int8
+        return QByteArray::number(((qint64)random << 20) - row);
+        break;
+    case 700:       // float4
+    case 701:       // float8
+        return QByteArray::number((double)random / 1000.0, 'g', 15);
+        break;
+    case 1700:      // numeric
+        return QByteArray::number((qint64)random - 2147483648LL).append('.').append(QByteArray::number(random % 100).rightJustified(2, '0'));
+        break;
+    case 1082:      // date
+        return QString("%1-%2-%3").arg(1970 + random % 100).arg(1 + random % 12, 2, 10, QChar('0'))
+                .arg(1 + random % 28, 2, 10, QChar('0')).toLatin1();
+        break;
+    case 1083:      // time
+        return QString("%1:%2:%3").arg(random % 24, 2, 10, QChar('0')).arg(random % 60, 2, 10, QChar('0'))
+                .arg((random >> 8) % 60, 2, 10, QChar('0')).toLatin1();
+        break;
+    case 1114:      // timestamp
+        return QString("%1-%2-%3 %4:%5:%6.%7").arg(1970 + random % 100).arg(1 + random % 12, 2, 10, QChar('0'))
+                .arg(1 + random % 28, 2, 10, QChar('0')).arg(random % 24, 2, 10, QChar('0'))
+                .arg(random % 60, 2, 10, QChar('0')).arg((random >> 8) % 60, 2, 10, QChar('0'))
+                .arg(random % 1000000, 6, 10, QChar('0')).toLatin1();
+        break;
+    case 1184:      // timestamptz
+        return QString("%1-%2-%3 %4:%5:%6.%7+%8").arg(1970 + random % 100).arg(1 + random % 12, 2, 10, QChar('0'))
+                .arg(1 + random % 28, 2, 10, QChar('0')).arg(random % 24, 2, 10, QChar('0'))
+                .arg(random % 60, 2, 10, QChar('0')).arg((random >> 8) % 60, 2, 10, QChar('0'))
+                .arg(random % 1000000, 6, 10, QChar('0')).arg((random >> 16) % 13, 2, 10, QChar('0')).toLatin1();
+        break;
+    case 17: {      // bytea
+        QByteArray bytes;
+        for (int index=0; index<16; ++index) {
+            bytes.append((char)(nextRandom(state) >> 24));
+        }
+        return QByteArray("\\x").append(bytes.toHex());
+        break;
+    }
+    default:
+        break;
+    }
+
+    return QByteArray("value_").append(QByteArray::number(row)).append('_').append(QByteArray::number(random, 16));
+}
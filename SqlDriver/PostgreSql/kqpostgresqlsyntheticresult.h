@@ -0,0 +1,57 @@
+#ifndef KQPOSTGRESQLSYNTHETICRESULT_H
+#define KQPOSTGRESQLSYNTHETICRESULT_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          KQPostgreSqlSyntheticResult
+ * -------------------------------------------------------------------------------------
+ * Builds a PGresult with generated values in the process. No server and no
+ * connection is needed. The shape of the result is configurable: number of
+ * rows, columns with their PostgreSql types and the ratio of NULL values.
+ * Values are generated in PostgreSql text format from a seed. The same seed
+ * gives the same result.
+ *
+ * The result can be handed to KQPostgreSqlDriver::createQuery(). Then the
+ * decoding in KQPostgreSqlResult can be profiled without network and server
+ * costs.
+ *
+ * Example:
+ *      KQPostgreSqlSyntheticResult shape(100000);
+ *      shape.addColumn("id", 20);
+ *      shape.addColumn("created", 1184);
+ *      shape.setNullRatio(0.1);
+ *      QSqlQuery query = driver.createQuery(shape.create());
+ */
+
+#include <libpq-fe.h>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+
+class KQPostgreSqlSyntheticResult
+{
+public:
+    explicit KQPostgreSqlSyntheticResult(const int rows);
+
+    void addColumn(const QString& name, const Oid type);
+    void setNullRatio(const double ratio)               { m_nullRatio = ratio; }
+    void setSeed(const quint32 seed)                    { m_seed = seed; }
+    int rows() const                                    { return m_rows; }
+    int columns() const                                 { return m_columnTypes.size(); }
+
+    PGresult* create() const;
+
+private:
+    static quint32 nextRandom(quint32& state);
+    static QByteArray valueOfType(const Oid type, const int row, quint32& state);
+
+private:
+    int m_rows;
+    double m_nullRatio;
+    quint32 m_seed;
+    QVector<QByteArray> m_columnNames;
+    QVector<Oid> m_columnTypes;
+};
+
+#endif // KQPOSTGRESQLSYNTHETICRESULT_H
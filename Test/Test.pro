@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# Unit tests of the container templates. All
+# containers are header only.
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+TARGET = tst_containers
+CONFIG   += console testcase c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += .. \
+    ../BinaryTree \
+    ../BTree
+
+SOURCES += main.cpp \
+    tst_binarytree.cpp \
+    tst_btree.cpp \
+    tst_sortlist.cpp \
+    tst_sortedvector.cpp \
+    tst_movesemantics.cpp
+
+HEADERS += testdata.h \
+    tst_binarytree.h \
+    tst_btree.h \
+    tst_sortlist.h \
+    tst_sortedvector.h \
+    tst_movesemantics.h
@@ -0,0 +1,27 @@
+#include "tst_binarytree.h"
+#include "tst_btree.h"
+#include "tst_sortlist.h"
+#include "tst_sortedvector.h"
+#include "tst_movesemantics.h"
+#include <QtTest>
+
+
+/**
+ * Runs all test classes of the containers.
+ */
+int main(int argc, char *argv[])
+{
+    int status = 0;
+    TestBinaryTree binaryTreeTest;
+    status |= QTest::qExec(&binaryTreeTest, argc, argv);
+    TestBTree bTreeTest;
+    status |= QTest::qExec(&bTreeTest, argc, argv);
+    TestSortList sortListTest;
+    status |= QTest::qExec(&sortListTest, argc, argv);
+    TestSortedVector sortedVectorTest;
+    status |= QTest::qExec(&sortedVectorTest, argc, argv);
+    TestMoveSemantics moveSemanticsTest;
+    status |= QTest::qExec(&moveSemanticsTest, argc, argv);
+
+    return status;
+}
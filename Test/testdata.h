@@ -0,0 +1,43 @@
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestData
+ * -------------------------------------------------------------------------------------
+ * User data for the container tests. Objects are compared by their key. The id
+ * tells equal objects apart. The operator << unites two objects and adds their
+ * counts.
+ */
+
+#include <QString>
+
+
+class TestData
+{
+public:
+    TestData(const int key = 0, const int id = 0) :
+        m_key(key),
+        m_id(id),
+        m_count(1)
+    {
+
+    }
+
+    int key() const                                     { return m_key; }
+    int id() const                                      { return m_id; }
+    int count() const                                   { return m_count; }
+    QString toString() const                            { return QString::number(m_key); }
+
+    bool operator < (const TestData& rhs) const         { return m_key < rhs.m_key; }
+    bool operator > (const TestData& rhs) const         { return m_key > rhs.m_key; }
+    bool operator == (const TestData& rhs) const        { return m_key == rhs.m_key; }
+    void operator << (const TestData& rhs)              { m_count += rhs.m_count; }
+
+private:
+    int m_key;
+    int m_id;
+    int m_count;
+};
+
+#endif // TESTDATA_H
@@ -0,0 +1,465 @@
+#include "tst_binarytree.h"
+#include "testdata.h"
+#include "binarytree.h"
+#include <QtTest>
+#include <QVector>
+#include <algorithm>
+
+
+/**
+ * Checks the heights of all nodes below pNode and the AVL condition.
+ * @param pNode         The root of a subtree.
+ * @param isAvl         True if the heights of subtrees may differ by one at most.
+ * @return              The height of the subtree or -1 if a check failed.
+ */
+static int checkedHeight(const TreeNode<TestData>* pNode, const bool isAvl)
+{
+    if (pNode == 0) {
+        return 0;
+    }
+    int left = checkedHeight(pNode->leftChild(), isAvl);
+    int rigth = checkedHeight(pNode->rigthChild(), isAvl);
+    if (left < 0 || rigth < 0) {
+        return -1;
+    }
+    if (isAvl && (left - rigth > 1 || rigth - left > 1)) {
+        return -1;
+    }
+    int height = qMax(left, rigth) + 1;
+
+    return height == pNode->height() ? height : -1;
+}
+
+/**
+ * Collects the keys of a tree in order.
+ */
+template<class Tree>
+static QVector<int> keysOf(const Tree& tree)
+{
+    QVector<int> keys;
+    for (typename Tree::iterator position = tree.begin(); position != tree.end(); ++position) {
+        keys.append(position->key());
+    }
+
+    return keys;
+}
+
+/**
+ * Collects the ids of a tree in order.
+ */
+template<class Tree>
+static QVector<int> idsOf(const Tree& tree)
+{
+    QVector<int> ids;
+    for (typename Tree::iterator position = tree.begin(); position != tree.end(); ++position) {
+        ids.append(position->id());
+    }
+
+    return ids;
+}
+
+/**
+ * Sorted input makes an unbalanced tree a list.
+ */
+void TestBinaryTree::insertUnbalanced()
+{
+    BinaryTree<TestData> tree;
+    for (int key=0; key<10; ++key) {
+        tree.insert(TestData(key));
+    }
+    QCOMPARE(tree.height(), 10);
+    QCOMPARE(keysOf(tree).size(), 10);
+    QVERIFY(checkedHeight(tree.findNodeWith(TestData(0)), false) > 0);
+}
+
+/**
+ * An AvlBalanced tree stays flat with sorted input.
+ */
+void TestBinaryTree::insertSortedAvl()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    QVector<int> expected;
+    for (int key=0; key<1000; ++key) {
+        tree.insert(TestData(key));
+        expected.append(key);
+    }
+    QVERIFY(tree.height() <= 14);
+    QCOMPARE(keysOf(tree), expected);
+    QCOMPARE(checkedHeight(tree.findNodeWith(TestData(0)), true), 1);
+    for (int key=999; key>=0; --key) {
+        QVERIFY(tree.findNodeWith(TestData(key)) != 0);
+    }
+    QVERIFY(tree.findNodeWith(TestData(1000)) == 0);
+}
+
+/**
+ * With the default allocator a node which was created with new can be
+ * inserted like before.
+ */
+void TestBinaryTree::insertHeapNode()
+{
+    BinaryTree<TestData> tree;
+    tree.insert(new TreeNode<TestData>(TestData(2)));
+    tree.insert(tree.createNode(TestData(1)));
+    tree.insert(new TreeNode<TestData>(TestData(3)));
+    QCOMPARE(keysOf(tree), QVector<int>() << 1 << 2 << 3);
+    tree.clear();
+    QCOMPARE(tree.height(), 0);
+}
+
+/**
+ * KeepEqual unites equal objects in one node.
+ */
+void TestBinaryTree::keepEqual()
+{
+    BinaryTree<TestData> tree;
+    tree.setEqualBehaviour(BinaryTree<TestData>::KeepEqual);
+    tree.insert(TestData(5));
+    tree.insert(TestData(5));
+    tree.insert(TestData(5));
+    QCOMPARE(keysOf(tree).size(), 1);
+    QCOMPARE(tree.findNodeWith(TestData(5))->userData().count(), 3);
+}
+
+/**
+ * Rotations keep the order of equal objects. With EqualToGreater they
+ * are in input order.
+ */
+void TestBinaryTree::equalOrder()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    tree.setEqualBehaviour(BinaryTree<TestData>::EqualToGreater);
+    for (int id=0; id<100; ++id) {
+        tree.insert(TestData(id % 2, id));
+    }
+    int lastId = -1;
+    int lastKey = 0;
+    for (BinaryTree<TestData>::iterator position = tree.begin(); position != tree.end(); ++position) {
+        if (position->key() != lastKey) {
+            lastKey = position->key();
+            lastId = -1;
+        }
+        QVERIFY(position->id() > lastId);
+        lastId = position->id();
+    }
+    QVERIFY(checkedHeight(tree.begin().node(), true) > 0);
+}
+
+/**
+ * In-order, pre-order and post-order iterators visit all nodes in their
+ * order.
+ */
+void TestBinaryTree::traversalOrders()
+{
+    BinaryTree<TestData> tree;
+    int keys[] = { 50, 20, 80, 10, 30, 70, 90, 25 };
+    for (int index=0; index<8; ++index) {
+        tree.insert(TestData(keys[index]));
+    }
+    QCOMPARE(keysOf(tree), QVector<int>() << 10 << 20 << 25 << 30 << 50 << 70 << 80 << 90);
+    QVector<int> preOrder;
+    for (BinaryTree<TestData>::PreOrderIterator position = tree.preOrderBegin(); position != tree.preOrderEnd(); ++position) {
+        preOrder.append(position->key());
+    }
+    QCOMPARE(preOrder, QVector<int>() << 50 << 20 << 10 << 30 << 25 << 80 << 70 << 90);
+    QVector<int> postOrder;
+    for (BinaryTree<TestData>::PostOrderIterator position = tree.postOrderBegin(); position != tree.postOrderEnd(); ++position) {
+        postOrder.append(position->key());
+    }
+    QCOMPARE(postOrder, QVector<int>() << 10 << 25 << 30 << 20 << 70 << 90 << 80 << 50);
+    BinaryTree<TestData> emptyTree;
+    QVERIFY(emptyTree.begin() == emptyTree.end());
+    QVERIFY(emptyTree.postOrderBegin() == emptyTree.postOrderEnd());
+}
+
+/**
+ * A tree which is a list of a million nodes is iterated and deleted
+ * without recursion. A recursive walk would overflow the call stack.
+ */
+void TestBinaryTree::deepTree()
+{
+    const int count = 1000000;
+    BinaryTree<TestData> tree;
+    TreeNode<TestData>* pLastNode = tree.createNode(TestData(0));
+    tree.insert(pLastNode);
+    for (int key=1; key<count; ++key) {
+        TreeNode<TestData>* pNode = tree.createNode(TestData(key));
+        pLastNode->setRigthChild(pNode);
+        pLastNode = pNode;
+    }
+    int expected = 0;
+    for (BinaryTree<TestData>::iterator position = tree.begin(); position != tree.end(); ++position) {
+        QCOMPARE(position->key(), expected);
+        ++expected;
+    }
+    QCOMPARE(expected, count);
+    int visited = 0;
+    for (BinaryTree<TestData>::PostOrderIterator position = tree.postOrderBegin(); position != tree.postOrderEnd(); ++position) {
+        ++visited;
+    }
+    QCOMPARE(visited, count);
+    tree.clear();
+    QVERIFY(tree.begin() == tree.end());
+}
+
+/**
+ * Removing a large subtree of an AvlBalanced tree updates the heights
+ * above it and keeps the tree balanced.
+ */
+void TestBinaryTree::removeDescendantsAvl()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    for (int key=0; key<1023; ++key) {
+        tree.insert(TestData(key));
+    }
+    int key = tree.preOrderBegin().node()->leftChild()->userData().key();
+    TreeNode<TestData>* pNode = tree.findNodeWith(TestData(key));
+    tree.removeDescendantsFrom(pNode);
+    QCOMPARE(pNode->height(), 1);
+    QVERIFY(checkedHeight(tree.preOrderBegin().node(), true) > 0);
+    QVERIFY(tree.findNodeWith(TestData(key)) == pNode);
+    QVector<int> keys = keysOf(tree);
+    QCOMPARE(keys.first(), key);
+    QVERIFY(std::is_sorted(keys.begin(), keys.end()));
+    tree.insert(TestData(-1));
+    QVERIFY(checkedHeight(tree.preOrderBegin().node(), true) > 0);
+}
+
+/**
+ * Removing a subtree of an unbalanced tree updates the heights above
+ * it. The shape of the tree is not changed.
+ */
+void TestBinaryTree::removeDescendantsUnbalanced()
+{
+    BinaryTree<TestData> tree;
+    int keys[] = { 50, 20, 80, 10, 30, 5, 15, 1, 90 };
+    for (int index=0; index<9; ++index) {
+        tree.insert(TestData(keys[index]));
+    }
+    QCOMPARE(tree.height(), 5);
+    tree.removeDescendantsFrom(tree.findNodeWith(TestData(10)));
+    QCOMPARE(tree.height(), 3);
+    QCOMPARE(checkedHeight(tree.preOrderBegin().node(), false), 3);
+    QCOMPARE(keysOf(tree), QVector<int>() << 10 << 20 << 30 << 50 << 80 << 90);
+}
+
+/**
+ * Nodes are taken from the pool. After clear() the memory is used again.
+ */
+void TestBinaryTree::poolAllocator()
+{
+    BinaryTree<TestData, PoolNodeAllocator> tree;
+    tree.setBalanceMode(BinaryTree<TestData, PoolNodeAllocator>::AvlBalanced);
+    for (int round=0; round<2; ++round) {
+        for (int key=0; key<1000; ++key) {
+            tree.insert(TestData((key * 7919) % 1000));
+        }
+        QVector<int> keys = keysOf(tree);
+        QCOMPARE(keys.size(), 1000);
+        QVERIFY(std::is_sorted(keys.begin(), keys.end()));
+        QVERIFY(tree.height() <= 14);
+        tree.clear();
+        QCOMPARE(tree.height(), 0);
+    }
+}
+
+/**
+ * erase() removes all equal objects and keeps an AvlBalanced tree
+ * balanced.
+ */
+void TestBinaryTree::eraseAvl()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    for (int index=0; index<2000; ++index) {
+        tree.insert(TestData((index * 7919) % 1000, index));
+    }
+    QCOMPARE(tree.erase(TestData(1000)), 0);
+    QVector<int> expected;
+    for (int key=0; key<1000; ++key) {
+        if (key % 3 == 0) {
+            QCOMPARE(tree.erase(TestData(key)), 2);
+            QVERIFY(tree.findNodeWith(TestData(key)) == 0);
+        } else {
+            expected << key << key;
+        }
+        QVERIFY(checkedHeight(tree.preOrderBegin().node(), true) > 0);
+    }
+    QCOMPARE(keysOf(tree), expected);
+    for (int key=0; key<1000; ++key) {
+        tree.erase(TestData(key));
+    }
+    QCOMPARE(tree.height(), 0);
+    QVERIFY(tree.begin() == tree.end());
+}
+
+/**
+ * erase() of the root, of inner nodes and of leaves in an unbalanced
+ * tree.
+ */
+void TestBinaryTree::eraseUnbalanced()
+{
+    BinaryTree<TestData> tree;
+    int keys[] = { 50, 20, 80, 10, 30, 70, 90, 25 };
+    for (int index=0; index<8; ++index) {
+        tree.insert(TestData(keys[index]));
+    }
+    QCOMPARE(tree.erase(TestData(50)), 1);
+    QCOMPARE(keysOf(tree), QVector<int>() << 10 << 20 << 25 << 30 << 70 << 80 << 90);
+    QCOMPARE(tree.erase(TestData(20)), 1);
+    QCOMPARE(tree.erase(TestData(90)), 1);
+    QCOMPARE(keysOf(tree), QVector<int>() << 10 << 25 << 30 << 70 << 80);
+    QVERIFY(checkedHeight(tree.preOrderBegin().node(), false) > 0);
+}
+
+/**
+ * lowerBound() and upperBound() behave like the STL functions with
+ * equal and missing keys.
+ */
+void TestBinaryTree::bounds()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    tree.setEqualBehaviour(BinaryTree<TestData>::EqualToGreater);
+    QVector<int> keys;
+    for (int index=0; index<300; ++index) {
+        int key = ((index * 7919) % 100) * 2;
+        tree.insert(TestData(key, index));
+        keys.append(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (int key=-1; key<=200; ++key) {
+        int lower = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+        int upper = std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+        BinaryTree<TestData>::iterator position = tree.lowerBound(TestData(key));
+        if (lower == keys.size()) {
+            QVERIFY(position == tree.end());
+        } else {
+            QCOMPARE(position->key(), keys[lower]);
+        }
+        int count = 0;
+        for (BinaryTree<TestData>::iterator last = tree.upperBound(TestData(key)); position != last; ++position) {
+            QCOMPARE(position->key(), key);
+            ++count;
+        }
+        QCOMPARE(count, upper - lower);
+    }
+    BinaryTree<TestData> emptyTree;
+    QVERIFY(emptyTree.lowerBound(TestData(1)) == emptyTree.end());
+    QVERIFY(emptyTree.upperBound(TestData(1)) == emptyTree.end());
+}
+
+/**
+ * forEachInRange() visits the objects of a closed range in order.
+ */
+void TestBinaryTree::forEachInRange()
+{
+    BinaryTree<TestData> tree;
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    for (int index=0; index<1000; ++index) {
+        tree.insert(TestData((index * 7919) % 1000));
+    }
+    QVector<int> visited;
+    tree.forEachInRange(TestData(100), TestData(199), [&visited](const TestData& data) { visited.append(data.key()); });
+    QCOMPARE(visited.size(), 100);
+    QCOMPARE(visited.first(), 100);
+    QCOMPARE(visited.last(), 199);
+    QVERIFY(std::is_sorted(visited.begin(), visited.end()));
+    visited.clear();
+    tree.forEachInRange(TestData(995), TestData(2000), [&visited](const TestData& data) { visited.append(data.key()); });
+    QCOMPARE(visited, QVector<int>() << 995 << 996 << 997 << 998 << 999);
+    visited.clear();
+    tree.forEachInRange(TestData(50), TestData(10), [&visited](const TestData& data) { visited.append(data.key()); });
+    QVERIFY(visited.isEmpty());
+}
+
+/**
+ * buildFromSorted() makes a perfectly balanced tree and replaces the
+ * content before.
+ */
+void TestBinaryTree::buildFromSorted()
+{
+    BinaryTree<TestData> tree;
+    tree.insert(TestData(-5));
+    QVector<TestData> input;
+    QVector<int> expected;
+    for (int key=0; key<1000; ++key) {
+        input.append(TestData(key));
+        expected.append(key);
+    }
+    tree.buildFromSorted(input.begin(), input.end());
+    QCOMPARE(tree.height(), 10);
+    QCOMPARE(keysOf(tree), expected);
+    QVERIFY(checkedHeight(tree.preOrderBegin().node(), true) > 0);
+    tree.setBalanceMode(BinaryTree<TestData>::AvlBalanced);
+    tree.insert(TestData(1000));
+    QVERIFY(checkedHeight(tree.preOrderBegin().node(), true) > 0);
+    tree.buildFromSorted(input.begin(), input.begin());
+    QCOMPARE(tree.height(), 0);
+}
+
+/**
+ * With KeepEqual equal objects are united while the tree is built.
+ */
+void TestBinaryTree::buildKeepEqual()
+{
+    BinaryTree<TestData> tree;
+    tree.setEqualBehaviour(BinaryTree<TestData>::KeepEqual);
+    QVector<TestData> input;
+    for (int index=0; index<30; ++index) {
+        input.append(TestData(index / 3, index));
+    }
+    tree.buildFromSorted(input.begin(), input.end());
+    QCOMPARE(keysOf(tree).size(), 10);
+    QCOMPARE(tree.height(), 4);
+    for (int key=0; key<10; ++key) {
+        QCOMPARE(tree.findNodeWith(TestData(key))->userData().count(), 3);
+    }
+}
+
+/**
+ * Equal objects are in the same order as after single inserts.
+ */
+void TestBinaryTree::buildEqualOrder()
+{
+    QVector<TestData> input;
+    for (int index=0; index<40; ++index) {
+        input.append(TestData(index / 4, index));
+    }
+    BinaryTree<TestData>::EqualBehaviour behaviours[] = { BinaryTree<TestData>::EqualToLesser,
+                                                          BinaryTree<TestData>::EqualToGreater };
+    for (int index=0; index<2; ++index) {
+        BinaryTree<TestData> builtTree;
+        builtTree.setEqualBehaviour(behaviours[index]);
+        builtTree.buildFromSorted(input.begin(), input.end());
+        BinaryTree<TestData> insertedTree;
+        insertedTree.setEqualBehaviour(behaviours[index]);
+        foreach (const TestData& data, input) {
+            insertedTree.insert(data);
+        }
+        QCOMPARE(idsOf(builtTree), idsOf(insertedTree));
+        QCOMPARE(builtTree.height(), 6);
+    }
+}
+
+/**
+ * The nodes of a built tree are taken from the pool.
+ */
+void TestBinaryTree::buildPoolAllocator()
+{
+    BinaryTree<TestData, PoolNodeAllocator> tree;
+    QVector<TestData> input;
+    for (int key=0; key<4095; ++key) {
+        input.append(TestData(key));
+    }
+    for (int round=0; round<2; ++round) {
+        tree.buildFromSorted(input.begin(), input.end());
+        QCOMPARE(tree.height(), 12);
+        QCOMPARE(keysOf(tree).size(), 4095);
+        QCOMPARE(tree.erase(TestData(2047)), 1);
+        QCOMPARE(keysOf(tree).size(), 4094);
+    }
+}
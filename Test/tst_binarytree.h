@@ -0,0 +1,40 @@
+#ifndef TST_BINARYTREE_H
+#define TST_BINARYTREE_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestBinaryTree
+ * -------------------------------------------------------------------------------------
+ * Tests of BinaryTree<T>. Checks order, heights and balance after inserts and
+ * removals with both balance modes and both allocators.
+ */
+
+#include <QObject>
+
+
+class TestBinaryTree : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertUnbalanced();
+    void insertSortedAvl();
+    void insertHeapNode();
+    void keepEqual();
+    void equalOrder();
+    void traversalOrders();
+    void deepTree();
+    void removeDescendantsAvl();
+    void removeDescendantsUnbalanced();
+    void poolAllocator();
+    void eraseAvl();
+    void eraseUnbalanced();
+    void bounds();
+    void forEachInRange();
+    void buildFromSorted();
+    void buildKeepEqual();
+    void buildEqualOrder();
+    void buildPoolAllocator();
+};
+
+#endif // TST_BINARYTREE_H
@@ -0,0 +1,177 @@
+#include "tst_btree.h"
+#include "testdata.h"
+#include "btree.h"
+#include <QtTest>
+#include <QVector>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+
+/**
+ * A key without default constructor. Counts its living objects.
+ */
+class CountedKey
+{
+public:
+    explicit CountedKey(const int key) : m_key(key)                 { ++living; }
+    CountedKey(const CountedKey& other) : m_key(other.m_key)        { ++living; }
+    CountedKey& operator = (const CountedKey& other)                { m_key = other.m_key; return *this; }
+    ~CountedKey()                                                   { --living; }
+
+    bool operator < (const CountedKey& rhs) const                   { return m_key < rhs.m_key; }
+    bool operator > (const CountedKey& rhs) const                   { return m_key > rhs.m_key; }
+    void operator << (const CountedKey& rhs)                        { (void)rhs; }
+    QString toString() const                                        { return QString::number(m_key); }
+
+    static int living;
+
+private:
+    int m_key;
+};
+
+int CountedKey::living = 0;
+
+
+/**
+ * A key which can be moved but not copied.
+ */
+class MoveOnlyKey
+{
+public:
+    explicit MoveOnlyKey(const int key) : m_pKey(new int(key))      { }
+
+    int key() const                                                 { return *m_pKey; }
+    bool operator < (const MoveOnlyKey& rhs) const                  { return *m_pKey < *rhs.m_pKey; }
+    bool operator > (const MoveOnlyKey& rhs) const                  { return *m_pKey > *rhs.m_pKey; }
+    void operator << (const MoveOnlyKey& rhs)                       { (void)rhs; }
+
+private:
+    std::unique_ptr<int> m_pKey;
+};
+
+
+/**
+ * Sorted input splits the rigth most nodes only.
+ */
+void TestBTree::insertSorted()
+{
+    BTree<TestData> tree;
+    for (int key=0; key<10000; ++key) {
+        tree.insert(TestData(key));
+    }
+    QCOMPARE(tree.size(), 10000);
+    int expected = 0;
+    for (BTree<TestData>::Iterator position = tree.begin(); position != tree.end(); ++position) {
+        QCOMPARE(position->key(), expected);
+        ++expected;
+    }
+    QCOMPARE(expected, 10000);
+    QVERIFY(tree.find(TestData(9999)) != 0);
+    QVERIFY(tree.find(TestData(10000)) == 0);
+    // Objects in the tree can not be changed through find().
+    QVERIFY((std::is_same<decltype(tree.find(TestData(0))), const TestData*>::value));
+}
+
+/**
+ * All keys of a shuffled input are found and iterated in order.
+ */
+void TestBTree::insertRandom()
+{
+    QVector<int> keys;
+    for (int key=0; key<10000; ++key) {
+        keys.append((key * 7919) % 10000);
+    }
+    BTree<TestData> tree;
+    for (int index=0; index<keys.size(); ++index) {
+        tree.insert(TestData(keys.at(index)));
+    }
+    for (int index=0; index<keys.size(); ++index) {
+        const TestData* pData = tree.find(TestData(keys.at(index)));
+        QVERIFY(pData != 0);
+        QCOMPARE(pData->key(), keys.at(index));
+    }
+    QVector<int> iterated;
+    for (BTree<TestData>::Iterator position = tree.begin(); position != tree.end(); ++position) {
+        iterated.append(position->key());
+    }
+    QCOMPARE(iterated.size(), 10000);
+    QVERIFY(std::is_sorted(iterated.begin(), iterated.end()));
+}
+
+/**
+ * KeepEqual unites equal objects. Also if the equal object is moved up
+ * by a split.
+ */
+void TestBTree::keepEqual()
+{
+    BTree<TestData> tree;
+    tree.setEqualBehaviour(BTree<TestData>::KeepEqual);
+    for (int round=0; round<3; ++round) {
+        for (int key=0; key<1000; ++key) {
+            tree.insert(TestData(key));
+        }
+    }
+    QCOMPARE(tree.size(), 1000);
+    QCOMPARE(tree.find(TestData(500))->count(), 3);
+}
+
+/**
+ * EqualToGreater keeps equal objects in input order.
+ */
+void TestBTree::equalOrder()
+{
+    BTree<TestData> tree;
+    tree.setEqualBehaviour(BTree<TestData>::EqualToGreater);
+    for (int id=0; id<3000; ++id) {
+        tree.insert(TestData(id % 3, id));
+    }
+    int lastKey = 0;
+    int lastId = -1;
+    for (BTree<TestData>::Iterator position = tree.begin(); position != tree.end(); ++position) {
+        if (position->key() != lastKey) {
+            lastKey = position->key();
+            lastId = -1;
+        }
+        QVERIFY(position->id() > lastId);
+        lastId = position->id();
+    }
+}
+
+/**
+ * Nodes construct only the keys they hold and destroy them. T needs no
+ * default constructor.
+ */
+void TestBTree::keyLifetime()
+{
+    {
+        BTree<CountedKey> tree;
+        for (int key=0; key<5000; ++key) {
+            tree.insert(CountedKey((key * 31) % 5000));
+        }
+        QCOMPARE(CountedKey::living, 5000);
+        tree.clear();
+        QCOMPARE(CountedKey::living, 0);
+        for (int key=0; key<100; ++key) {
+            tree.insert(CountedKey(key));
+        }
+    }
+    QCOMPARE(CountedKey::living, 0);
+}
+
+/**
+ * Keys are moved into the tree and between nodes.
+ */
+void TestBTree::moveOnlyKeys()
+{
+    BTree<MoveOnlyKey> tree;
+    for (int key=999; key>=0; --key) {
+        tree.insert(MoveOnlyKey(key));
+    }
+    int expected = 0;
+    for (BTree<MoveOnlyKey>::Iterator position = tree.begin(); position != tree.end(); ++position) {
+        QCOMPARE(position->key(), expected);
+        ++expected;
+    }
+    QCOMPARE(expected, 1000);
+}
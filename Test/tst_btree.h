@@ -0,0 +1,28 @@
+#ifndef TST_BTREE_H
+#define TST_BTREE_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestBTree
+ * -------------------------------------------------------------------------------------
+ * Tests of BTree<T>. Checks order and lookup after many splits and the lifetime
+ * of keys in the raw key storage of the nodes.
+ */
+
+#include <QObject>
+
+
+class TestBTree : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertSorted();
+    void insertRandom();
+    void keepEqual();
+    void equalOrder();
+    void keyLifetime();
+    void moveOnlyKeys();
+};
+
+#endif // TST_BTREE_H
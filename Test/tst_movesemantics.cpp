@@ -0,0 +1,199 @@
+#include "tst_movesemantics.h"
+#include "sortlist.h"
+#include "sortedvector.h"
+#include "binarytree.h"
+#include "btree.h"
+#include <QtTest>
+#include <vector>
+
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          CopyCounter
+ * -------------------------------------------------------------------------------------
+ * A data object which counts how often objects are copied and moved. A moved
+ * object has the key -1. The move operations are noexcept. Else std::vector copies
+ * the elements when it grows.
+ */
+class CopyCounter
+{
+public:
+    CopyCounter(const int key = 0) :
+        m_key(key)
+    {
+
+    }
+
+    CopyCounter(const CopyCounter& other) :
+        m_key(other.m_key)
+    {
+        ++copies;
+    }
+
+    CopyCounter(CopyCounter&& other) noexcept :
+        m_key(other.m_key)
+    {
+        other.m_key = -1;
+        ++moves;
+    }
+
+    CopyCounter& operator = (const CopyCounter& other)  { m_key = other.m_key; ++copies; return *this; }
+    CopyCounter& operator = (CopyCounter&& other) noexcept { m_key = other.m_key; other.m_key = -1; ++moves; return *this; }
+
+    int key() const                                     { return m_key; }
+    void setKey(const int key)                          { m_key = key; }
+    QString toString() const                            { return QString::number(m_key); }
+
+    bool operator < (const CopyCounter& rhs) const      { return m_key < rhs.m_key; }
+    bool operator > (const CopyCounter& rhs) const      { return m_key > rhs.m_key; }
+    bool operator == (const CopyCounter& rhs) const     { return m_key == rhs.m_key; }
+    void operator << (const CopyCounter& rhs)           { (void)rhs; }
+
+    static int copies;
+    static int moves;
+
+private:
+    int m_key;
+};
+
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+/**
+ * Resets the counters before each test.
+ */
+void TestMoveSemantics::init()
+{
+    CopyCounter::copies = 0;
+    CopyCounter::moves = 0;
+}
+
+/**
+ * SortList moves data into nodes and out of the list. The iterator
+ * returns a reference to the data of the node.
+ */
+void TestMoveSemantics::sortList()
+{
+    SortList<CopyCounter> list;
+    for (int index=0; index<1000; ++index) {
+        CopyCounter data((index * 7919) % 1000);
+        list.insert(std::move(data));
+        QCOMPARE(data.key(), -1);
+        list.emplace(1000 + index);
+    }
+    QCOMPARE(CopyCounter::copies, 0);
+    SortListIterator<CopyCounter> iterator = list.begin();
+    QVERIFY(&iterator.data() == &list.begin().data());
+    std::vector<CopyCounter> elements = list.takeVector();
+    QCOMPARE(CopyCounter::copies, 0);
+    QCOMPARE((int)elements.size(), 2000);
+    for (int index=0; index<2000; ++index) {
+        QCOMPARE(elements[index].key(), index);
+    }
+}
+
+/**
+ * BinaryTree moves data into nodes. userData() returns a reference. So
+ * the data of a node can be changed in place.
+ */
+void TestMoveSemantics::binaryTree()
+{
+    BinaryTree<CopyCounter> tree;
+    tree.setBalanceMode(BinaryTree<CopyCounter>::AvlBalanced);
+    for (int index=0; index<1000; ++index) {
+        tree.insert(CopyCounter(index * 2));
+        tree.emplace(index * 2 + 1);
+    }
+    QCOMPARE(CopyCounter::copies, 0);
+    TreeNode<CopyCounter>* pNode = tree.findNodeWith(CopyCounter(10));
+    pNode->userData().setKey(11);
+    QCOMPARE(tree.findNodeWith(CopyCounter(11))->userData().key(), 11);
+    QVERIFY(&*tree.lowerBound(CopyCounter(0)) == &tree.begin().node()->userData());
+    QCOMPARE(CopyCounter::copies, 0);
+}
+
+/**
+ * BTree moves data into nodes and between nodes when they are split.
+ */
+void TestMoveSemantics::bTree()
+{
+    BTree<CopyCounter> tree;
+    for (int index=0; index<10000; ++index) {
+        tree.insert(CopyCounter((index * 7919) % 10000));
+    }
+    QCOMPARE(CopyCounter::copies, 0);
+    QVERIFY(CopyCounter::moves >= 10000);
+    for (int key=0; key<10000; ++key) {
+        QVERIFY(tree.find(CopyCounter(key)) != 0);
+    }
+    QCOMPARE(CopyCounter::copies, 0);
+}
+
+/**
+ * SortedVector moves data into the vector, when collected elements are
+ * merged and out of the container.
+ */
+void TestMoveSemantics::sortedVector()
+{
+    SortedVector<CopyCounter> vector;
+    for (int index=0; index<500; ++index) {
+        vector.insert(CopyCounter(index * 2));
+        vector.append(CopyCounter(index * 2 + 1));
+    }
+    vector.emplace(1000);
+    QCOMPARE(vector.size(), 1001);
+    QCOMPARE(CopyCounter::copies, 0);
+    std::vector<CopyCounter> elements = vector.takeVector();
+    QCOMPARE(CopyCounter::copies, 0);
+    for (int index=0; index<1001; ++index) {
+        QCOMPARE(elements[index].key(), index);
+    }
+}
+
+/**
+ * insert(const T&) copies each object once and keeps the original.
+ */
+void TestMoveSemantics::copyInsert()
+{
+    CopyCounter data(5);
+    SortList<CopyCounter> list;
+    list.insert(data);
+    BinaryTree<CopyCounter> tree;
+    tree.insert(data);
+    BTree<CopyCounter> bTree;
+    bTree.insert(data);
+    SortedVector<CopyCounter> vector;
+    vector.insert(data);
+    QCOMPARE(CopyCounter::copies, 4);
+    QCOMPARE(data.key(), 5);
+}
+
+/**
+ * emplace() of SortList and BinaryTree constructs the data object in the
+ * new node. It is neither copied nor moved. Also not if an equal element
+ * takes the data.
+ */
+void TestMoveSemantics::emplaceInPlace()
+{
+    SortList<CopyCounter> list(SortList<CopyCounter>::DropDoublicate);
+    BinaryTree<CopyCounter> tree;
+    tree.setBalanceMode(BinaryTree<CopyCounter>::AvlBalanced);
+    for (int index=0; index<1000; ++index) {
+        list.emplace((index * 7919) % 500);
+        tree.emplace((index * 7919) % 1000);
+    }
+    QCOMPARE(CopyCounter::copies, 0);
+    QCOMPARE(CopyCounter::moves, 0);
+    QCOMPARE(list.size(), 500);
+    SortListIterator<CopyCounter> iterator = list.begin();
+    for (int index=0; index<500; ++index) {
+        QCOMPARE(iterator.data().key(), index);
+        iterator.next();
+    }
+    int key = 0;
+    for (BinaryTree<CopyCounter>::iterator position = tree.begin(); position != tree.end(); ++position) {
+        QCOMPARE((*position).key(), key);
+        ++key;
+    }
+    QCOMPARE(key, 1000);
+}
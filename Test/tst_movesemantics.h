@@ -0,0 +1,29 @@
+#ifndef TST_MOVESEMANTICS_H
+#define TST_MOVESEMANTICS_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestMoveSemantics
+ * -------------------------------------------------------------------------------------
+ * Tests of insert(T&&), emplace(), the reference accessors and takeVector() of all
+ * containers. A data object counts its copies. Moved objects must not be copied.
+ */
+
+#include <QObject>
+
+
+class TestMoveSemantics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void sortList();
+    void binaryTree();
+    void bTree();
+    void sortedVector();
+    void copyInsert();
+    void emplaceInPlace();
+};
+
+#endif // TST_MOVESEMANTICS_H
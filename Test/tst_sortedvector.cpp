@@ -0,0 +1,186 @@
+#include "tst_sortedvector.h"
+#define CanUniteData
+#include "testdata.h"
+#include "sortedvector.h"
+#include <QtTest>
+#include <QVector>
+#include <algorithm>
+#include <vector>
+
+
+/**
+ * Collects the keys of a vector in order.
+ */
+static QVector<int> keysOf(const SortedVector<TestData>& vector)
+{
+    QVector<int> keys;
+    for (int index=0; index<vector.size(); ++index) {
+        keys.append(vector.at(index).key());
+    }
+
+    return keys;
+}
+
+/**
+ * Collects the ids of a vector in order.
+ */
+static QVector<int> idsOf(const SortedVector<TestData>& vector)
+{
+    QVector<int> ids;
+    for (int index=0; index<vector.size(); ++index) {
+        ids.append(vector.at(index).id());
+    }
+
+    return ids;
+}
+
+/**
+ * insert() returns the position of the new element. Lookups find all
+ * elements.
+ */
+void TestSortedVector::insertPositions()
+{
+    SortedVector<TestData> vector;
+    std::vector<int> sorted;
+    for (int index=0; index<2000; ++index) {
+        int key = (index * 7919) % 1000;
+        int expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        sorted.insert(sorted.begin() + expected, key);
+        QCOMPARE(vector.insert(TestData(key)), expected);
+    }
+    QCOMPARE(vector.size(), 2000);
+    for (int key=0; key<1000; ++key) {
+        QCOMPARE(vector.indexOf(TestData(key)), key * 2);
+        QVERIFY(vector.find(TestData(key)) == &vector.at(key * 2));
+    }
+    QCOMPARE(vector.indexOf(TestData(1000)), -1);
+    QVERIFY(vector.find(TestData(-1)) == 0);
+    QCOMPARE(vector.lowerBound(TestData(5000)), 2000);
+}
+
+/**
+ * The equal behaviours work like in SortList.
+ */
+void TestSortedVector::equalBehaviours()
+{
+    SortedVector<TestData> doublicates;
+    SortedVector<TestData> dropped(SortedVector<TestData>::DropDoublicate);
+    SortedVector<TestData> united(SortedVector<TestData>::UniteNodeData);
+    for (int id=0; id<4; ++id) {
+        doublicates.insert(TestData(7, id));
+        dropped.insert(TestData(7, id));
+        united.insert(TestData(7, id));
+    }
+    QCOMPARE(idsOf(doublicates), QVector<int>() << 3 << 2 << 1 << 0);
+    QCOMPARE(idsOf(dropped), QVector<int>() << 0);
+    QCOMPARE(united.size(), 1);
+    QCOMPARE(united.at(0).count(), 4);
+}
+
+/**
+ * Collected elements give the same vector as single inserts with each
+ * equal behaviour.
+ */
+void TestSortedVector::appendRange()
+{
+    SortedVector<TestData>::EqualBehaviour behaviours[] = { SortedVector<TestData>::UniteNodeData,
+                                                            SortedVector<TestData>::InsertDoublicate,
+                                                            SortedVector<TestData>::DropDoublicate };
+    for (int index=0; index<3; ++index) {
+        SortedVector<TestData> appended(behaviours[index]);
+        SortedVector<TestData> inserted(behaviours[index]);
+        std::vector<TestData> batch;
+        for (int id=0; id<300; ++id) {
+            TestData data((id * 7919) % 100, id);
+            if (id < 100) {
+                appended.insert(data);
+                inserted.insert(data);
+            } else if (id < 150) {
+                appended.append(data);
+                inserted.insert(data);
+            } else {
+                batch.push_back(data);
+                inserted.insert(data);
+            }
+        }
+        appended.appendRange(batch.begin(), batch.end());
+        QCOMPARE(appended.size(), inserted.size());
+        QCOMPARE(keysOf(appended), keysOf(inserted));
+        QCOMPARE(idsOf(appended), idsOf(inserted));
+        for (int position=0; position<appended.size(); ++position) {
+            QCOMPARE(appended.at(position).count(), inserted.at(position).count());
+        }
+    }
+}
+
+/**
+ * toArray() and searchArray() work on the memory of the vector. Reading
+ * them merges collected elements first.
+ */
+void TestSortedVector::views()
+{
+    SortedVector<TestData> vector;
+    QVERIFY(vector.toArray() == 0);
+    QVERIFY(vector.searchArray().findObject(TestData(1)) == 0);
+    for (int key=99; key>=0; --key) {
+        vector.append(TestData(key));
+    }
+    const TestData* pArray = vector.toArray();
+    QVERIFY(pArray != 0);
+    QVERIFY(pArray == &vector.at(0));
+    for (int index=0; index<100; ++index) {
+        QCOMPARE(pArray[index].key(), index);
+    }
+    BinarySearchArray<TestData> searchArray = vector.searchArray();
+    for (int key=0; key<100; ++key) {
+        QVERIFY(searchArray.findObject(TestData(key)) == &pArray[key]);
+    }
+    QVERIFY(searchArray.findObject(TestData(100)) == 0);
+}
+
+/**
+ * takeVector() moves all elements out and leaves an empty container.
+ */
+void TestSortedVector::takeVector()
+{
+    SortedVector<TestData> vector;
+    for (int key=0; key<50; ++key) {
+        vector.append(TestData(49 - key));
+    }
+    std::vector<TestData> elements = vector.takeVector();
+    QVERIFY(vector.isEmpty());
+    QCOMPARE((int)elements.size(), 50);
+    for (int index=0; index<50; ++index) {
+        QCOMPARE(elements[index].key(), index);
+    }
+}
+
+/**
+ * The binary search finds each element of odd and even lengths and no
+ * element which is missing.
+ */
+void TestSortedVector::binarySearchArray()
+{
+    for (int length=0; length<20; ++length) {
+        TestData* pArray = new TestData[length];
+        for (int index=0; index<length; ++index) {
+            pArray[index] = TestData(index * 2);
+        }
+        BinarySearchArray<TestData> searchArray(pArray, length, true);
+        for (int key=-1; key<=length*2; ++key) {
+            TestData* pFound = searchArray.findObject(TestData(key));
+            if (key >= 0 && key < length*2 && key % 2 == 0) {
+                QVERIFY(pFound == &pArray[key / 2]);
+            } else {
+                QVERIFY(pFound == 0);
+            }
+        }
+    }
+    Range range(5);
+    QCOMPARE(range.median(), 2);
+    range.setStart(3);
+    QCOMPARE(range.median(), 3);
+    range.setEnd(2);
+    QVERIFY(! range.isValid());
+    QVERIFY(! Range(0).isValid());
+}
@@ -0,0 +1,29 @@
+#ifndef TST_SORTEDVECTOR_H
+#define TST_SORTEDVECTOR_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestSortedVector
+ * -------------------------------------------------------------------------------------
+ * Tests of SortedVector<T> and BinarySearchArray<T>. Checks positions, equal
+ * behaviours, the deferred merge of collected elements and the views on the
+ * vector.
+ */
+
+#include <QObject>
+
+
+class TestSortedVector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertPositions();
+    void equalBehaviours();
+    void appendRange();
+    void views();
+    void takeVector();
+    void binarySearchArray();
+};
+
+#endif // TST_SORTEDVECTOR_H
@@ -0,0 +1,314 @@
+#include "tst_sortlist.h"
+#define CanUniteData
+#include "testdata.h"
+#include "sortlist.h"
+#include <QtTest>
+#include <QVector>
+#include <algorithm>
+#include <vector>
+
+
+/**
+ * Collects the keys of a list in order.
+ */
+template<class List>
+static QVector<int> keysOf(const List& list)
+{
+    QVector<int> keys;
+    if (list.isEmpty()) {
+        return keys;
+    }
+    SortListIterator<TestData> iterator = list.begin();
+    do {
+        keys.append(iterator.data().key());
+    } while (iterator.next());
+
+    return keys;
+}
+
+/**
+ * Collects the ids of a list in order.
+ */
+template<class List>
+static QVector<int> idsOf(const List& list)
+{
+    QVector<int> ids;
+    if (list.isEmpty()) {
+        return ids;
+    }
+    SortListIterator<TestData> iterator = list.begin();
+    do {
+        ids.append(iterator.data().id());
+    } while (iterator.next());
+
+    return ids;
+}
+
+/**
+ * Inserts keys in a shuffled order. Each position which insert()
+ * returns is checked against a sorted vector.
+ */
+template<class List>
+static bool insertShuffled(List& list, const int count)
+{
+    std::vector<int> sorted;
+    for (int index=0; index<count; ++index) {
+        int key = (index * 7919) % count;
+        std::vector<int>::iterator position = std::lower_bound(sorted.begin(), sorted.end(), key);
+        int expected = position - sorted.begin();
+        sorted.insert(position, key);
+        if (list.insert(TestData(key)) != expected) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * insert() returns the position of the new element with sorted, reversed
+ * and shuffled input.
+ */
+void TestSortList::insertPositions()
+{
+    SortList<TestData> list;
+    for (int key=0; key<3000; ++key) {
+        QCOMPARE(list.insert(TestData(key)), key);
+    }
+    for (int key=-1; key>=-3000; --key) {
+        QCOMPARE(list.insert(TestData(key)), 0);
+    }
+    QCOMPARE(list.size(), 6000);
+    QCOMPARE(keysOf(list).first(), -3000);
+    SortList<TestData> shuffledList;
+    QVERIFY(insertShuffled(shuffledList, 20000));
+    QCOMPARE(shuffledList.size(), 20000);
+}
+
+/**
+ * With InsertDoublicate a new element is placed before equal elements.
+ */
+void TestSortList::insertDoublicate()
+{
+    SortList<TestData> list;
+    std::vector<int> sorted;
+    for (int id=0; id<2000; ++id) {
+        int key = (id * 7919) % 100;
+        int expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        sorted.insert(sorted.begin() + expected, key);
+        QCOMPARE(list.insert(TestData(key, id)), expected);
+    }
+    QCOMPARE(list.size(), 2000);
+    SortListIterator<TestData> iterator = list.begin();
+    int lastId = 2000;
+    do {
+        if (iterator.data().key() == 0) {
+            QVERIFY(iterator.data().id() < lastId);
+            lastId = iterator.data().id();
+        }
+    } while (iterator.next());
+}
+
+/**
+ * With DropDoublicate equal elements are not inserted. insert() returns
+ * the position of the element in the list.
+ */
+void TestSortList::dropDoublicate()
+{
+    SortList<TestData> list(SortList<TestData>::DropDoublicate);
+    for (int index=0; index<1000; ++index) {
+        int key = (index * 7919) % 500;
+        int position = list.insert(TestData(key, index));
+        if (index >= 500) {
+            QCOMPARE(position, key);
+        }
+    }
+    QCOMPARE(list.size(), 500);
+    QCOMPARE(list.begin().data().id(), 0);
+    QVector<int> keys = keysOf(list);
+    for (int key=0; key<500; ++key) {
+        QCOMPARE(keys.at(key), key);
+    }
+}
+
+/**
+ * With UniteNodeData equal elements are united with the << operator.
+ */
+void TestSortList::uniteNodeData()
+{
+    SortList<TestData> list(SortList<TestData>::UniteNodeData);
+    for (int index=0; index<1000; ++index) {
+        int key = (index * 7919) % 250;
+        int position = list.insert(TestData(key));
+        if (index >= 250) {
+            QCOMPARE(position, key);
+        }
+    }
+    QCOMPARE(list.size(), 250);
+    SortListIterator<TestData> iterator = list.begin();
+    do {
+        QCOMPARE(iterator.data().count(), 4);
+    } while (iterator.next());
+}
+
+/**
+ * The iterator moves in both directions and keeps its position at the
+ * ends of the list.
+ */
+void TestSortList::iterator()
+{
+    SortList<TestData> list;
+    QVERIFY(insertShuffled(list, 100));
+    SortListIterator<TestData> iterator = list.end();
+    QCOMPARE(iterator.data().key(), 99);
+    QVERIFY(! iterator.next());
+    int key = 99;
+    while (iterator.previous()) {
+        --key;
+        QCOMPARE(iterator.data().key(), key);
+    }
+    QCOMPARE(key, 0);
+    QCOMPARE(iterator.data().key(), 0);
+    QVERIFY(iterator.next());
+    QCOMPARE(iterator.data().key(), 1);
+}
+
+/**
+ * insertRange() merges a batch into a list. Positions of single inserts
+ * are right afterwards. So the skip list levels are valid.
+ */
+void TestSortList::insertRange()
+{
+    SortList<TestData> list;
+    std::vector<TestData> batch;
+    for (int index=0; index<5000; ++index) {
+        batch.push_back(TestData(((index * 7919) % 5000) * 2));
+    }
+    QCOMPARE(list.insertRange(batch.begin(), batch.begin()), 0);
+    QCOMPARE(list.insertRange(batch.begin(), batch.begin() + 2500), 2500);
+    QCOMPARE(list.insertRange(batch.begin() + 2500, batch.end()), 2500);
+    QCOMPARE(list.size(), 5000);
+    QVector<int> keys = keysOf(list);
+    for (int index=0; index<5000; ++index) {
+        QCOMPARE(keys.at(index), index * 2);
+    }
+    for (int key=1; key<1000; key+=2) {
+        QCOMPARE(list.insert(TestData(key)), key);
+    }
+    QCOMPARE(list.insert(TestData(20000)), 5500);
+}
+
+/**
+ * insertRange() gives the same list as single inserts with each equal
+ * behaviour.
+ */
+void TestSortList::insertRangeEqual()
+{
+    SortList<TestData>::EqualBehaviour behaviours[] = { SortList<TestData>::UniteNodeData,
+                                                        SortList<TestData>::InsertDoublicate,
+                                                        SortList<TestData>::DropDoublicate };
+    for (int index=0; index<3; ++index) {
+        SortList<TestData> rangeList(behaviours[index]);
+        SortList<TestData> singleList(behaviours[index]);
+        std::vector<TestData> batch;
+        for (int id=0; id<300; ++id) {
+            TestData data((id * 7919) % 100, id);
+            if (id < 100) {
+                rangeList.insert(data);
+                singleList.insert(data);
+            } else {
+                batch.push_back(data);
+            }
+        }
+        for (size_t position=0; position<batch.size(); ++position) {
+            singleList.insert(batch[position]);
+        }
+        rangeList.insertRange(batch.begin(), batch.end());
+        QCOMPARE(rangeList.size(), singleList.size());
+        QCOMPARE(keysOf(rangeList), keysOf(singleList));
+        QCOMPARE(idsOf(rangeList), idsOf(singleList));
+        SortListIterator<TestData> rangeIterator = rangeList.begin();
+        SortListIterator<TestData> singleIterator = singleList.begin();
+        do {
+            QCOMPARE(rangeIterator.data().count(), singleIterator.data().count());
+            singleIterator.next();
+        } while (rangeIterator.next());
+    }
+}
+
+/**
+ * Nodes and towers are taken from the pool. After clear() the memory
+ * is used again.
+ */
+void TestSortList::poolAllocator()
+{
+    SortList<TestData, PoolNodeAllocator> list;
+    QVERIFY(insertShuffled(list, 5000));
+    QCOMPARE(list.size(), 5000);
+    list.clear();
+    QVERIFY(list.isEmpty());
+    QVERIFY(insertShuffled(list, 5000));
+    QVector<int> keys = keysOf(list);
+    QCOMPARE(keys.size(), 5000);
+    QVERIFY(std::is_sorted(keys.begin(), keys.end()));
+}
+
+/**
+ * takeVector() moves all elements out and clears the list.
+ */
+void TestSortList::takeVector()
+{
+    SortList<TestData> list;
+    QVERIFY(insertShuffled(list, 1000));
+    std::vector<TestData> elements = list.takeVector();
+    QVERIFY(list.isEmpty());
+    QCOMPARE((int)elements.size(), 1000);
+    for (int index=0; index<1000; ++index) {
+        QCOMPARE(elements[index].key(), index);
+    }
+    QVERIFY(list.takeVector().empty());
+    QVERIFY(insertShuffled(list, 100));
+}
+
+/**
+ * Arrays of each size class can be written and are taken again after
+ * deallocate() or reset().
+ */
+void TestSortList::nodeArrayAllocator()
+{
+    NodeArrayAllocator<int, PoolNodeAllocator> allocator;
+    int* arrays[16];
+    for (int count=1; count<=16; ++count) {
+        arrays[count - 1] = allocator.allocate(count);
+        for (int index=0; index<count; ++index) {
+            QCOMPARE(arrays[count - 1][index], 0);
+            arrays[count - 1][index] = count;
+        }
+    }
+    for (int count=1; count<=16; ++count) {
+        for (int index=0; index<count; ++index) {
+            QCOMPARE(arrays[count - 1][index], count);
+        }
+    }
+    allocator.deallocate(arrays[2], 3);
+    QVERIFY(allocator.allocate(4) == arrays[2]);
+    allocator.reset();
+    QVERIFY(allocator.allocate(1) == arrays[0]);
+    NodeArrayAllocator<int, HeapNodeAllocator> heapAllocator;
+    int* pArray = heapAllocator.allocate(5);
+    pArray[4] = 1;
+    heapAllocator.deallocate(pArray, 5);
+    // Arrays larger than MaxCount are taken from the heap.
+    int* pLarge = heapAllocator.allocate(40);
+    for (int index=0; index<40; ++index) {
+        QCOMPARE(pLarge[index], 0);
+        pLarge[index] = index;
+    }
+    QCOMPARE(pLarge[39], 39);
+    heapAllocator.deallocate(pLarge, 40);
+    pLarge = allocator.allocate(17);
+    pLarge[16] = 1;
+    allocator.allocate(100)[99] = 1;
+    allocator.deallocate(pLarge, 17);
+    allocator.reset();
+}
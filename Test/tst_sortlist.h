@@ -0,0 +1,32 @@
+#ifndef TST_SORTLIST_H
+#define TST_SORTLIST_H
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Class:          TestSortList
+ * -------------------------------------------------------------------------------------
+ * Tests of SortList<T>. Checks order and positions of the skip list with both
+ * allocators and the arrays of NodeArrayAllocator.
+ */
+
+#include <QObject>
+
+
+class TestSortList : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertPositions();
+    void insertDoublicate();
+    void dropDoublicate();
+    void uniteNodeData();
+    void iterator();
+    void insertRange();
+    void insertRangeEqual();
+    void poolAllocator();
+    void takeVector();
+    void nodeArrayAllocator();
+};
+
+#endif // TST_SORTLIST_H
@@ -0,0 +1,352 @@
+#ifndef NODEALLOCATOR_H
+#define NODEALLOCATOR_H
+
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+
+/**
+ * ---------------------------------------------------------------------------------
+ * Allocator policies for list and tree nodes
+ * ---------------------------------------------------------------------------------
+ * The containers SortList and BinaryTree take an allocator policy as template
+ * parameter. The allocator gives memory for one node. The container constructs
+ * and destroys the node in this memory.
+ *
+ * An allocator policy is a template class with one parameter (the node type).
+ * It must have these members:
+ * - void* allocate()           Memory for one node.
+ * - void deallocate(void* p)   Gives the memory of one node back.
+ * - void reset()               Gives the memory of all nodes back at once.
+ * - void reserve(int count)    Prepares memory for count nodes.
+ * - enum { CanReset }          True if reset() frees memory. Then the container
+ *                              does not need to deallocate node by node.
+ *
+ * HeapNodeAllocator
+ *      Each node is a single heap allocation. This is the default policy.
+ * PoolNodeAllocator
+ *      Nodes are taken from large slabs. Freed nodes are kept in a free list.
+ *      reset() makes all slabs available again without freeing them.
+ *
+ * NodeArrayAllocator takes an allocator policy and gives memory for small arrays
+ * of variable length, like the towers of a skip list node.
+ */
+
+
+/**
+ * ---------------------------------------------------------------------------------
+ * Template class:      HeapNodeAllocator
+ * ---------------------------------------------------------------------------------
+ * Allocates each node with operator new. Nodes can be deleted one by one.
+ * Memory of these nodes is compatible to 'new Node' and 'delete pNode'.
+ */
+template<class Node>
+class HeapNodeAllocator
+{
+public:
+    enum { CanReset = false };
+
+    void* allocate()                        { return ::operator new(sizeof(Node)); }
+    void deallocate(void* pMemory)          { ::operator delete(pMemory); }
+    void reset()                            { }
+    void reserve(const int count)           { (void)count; }
+};
+
+
+/**
+ * ---------------------------------------------------------------------------------
+ * Template class:      PoolNodeAllocator
+ * ---------------------------------------------------------------------------------
+ * Takes node memory from slabs. A slab keeps SlabSize nodes or more if memory
+ * was reserved. Deallocated nodes are put into a free list and are taken first
+ * by allocate().
+ * reset() drops the free list and starts again with the first slab. The slabs
+ * are not freed before the allocator is destroyed. So nodes of a container can
+ * be released in O(1) and the memory is reused by the next nodes.
+ * reserve() makes sure that the next nodes are taken one after another from one
+ * slab. Then nodes of a bulk build are contiguous in memory.
+ * The allocator can not be copied.
+ */
+template<class Node>
+class PoolNodeAllocator
+{
+public:
+    enum { CanReset = true, SlabSize = 256 };
+
+    PoolNodeAllocator() :
+        m_pFreeList(0),
+        m_currentSlab(0),
+        m_used(0)
+    {
+
+    }
+
+    PoolNodeAllocator(const PoolNodeAllocator&) = delete;
+    PoolNodeAllocator& operator = (const PoolNodeAllocator&) = delete;
+
+    ~PoolNodeAllocator()
+    {
+        for (size_t index=0; index<m_slabs.size(); ++index) {
+            ::operator delete(m_slabs[index].pSlots);
+        }
+    }
+
+    void* allocate();
+    void deallocate(void* pMemory);
+    void reset();
+    void reserve(const int count);
+
+private:
+    // A slot keeps a node or a link to the next free slot.
+    union Slot {
+        Slot* pNext;
+        alignas(Node) char node[sizeof(Node)];
+    };
+    struct Slab {
+        Slot* pSlots;
+        int capacity;
+    };
+
+    void addSlab(const int capacity, const size_t position);
+
+private:
+    Slot* m_pFreeList;
+    std::vector<Slab> m_slabs;
+    size_t m_currentSlab;
+    int m_used;
+};
+
+/**
+ * Get memory for one node. Takes a slot from the free list or the next
+ * unused slot of the current slab. A new slab is added if all slabs
+ * are used.
+ * @return          Memory for one node.
+ */
+template<class Node>
+void *PoolNodeAllocator<Node>::allocate()
+{
+    if (m_pFreeList != 0) {
+        Slot* pSlot = m_pFreeList;
+        m_pFreeList = pSlot->pNext;
+        return pSlot;
+    }
+    while (m_currentSlab < m_slabs.size() && m_used == m_slabs[m_currentSlab].capacity) {
+        ++m_currentSlab;
+        m_used = 0;
+    }
+    if (m_currentSlab == m_slabs.size()) {
+        addSlab(SlabSize, m_slabs.size());
+    }
+
+    return &m_slabs[m_currentSlab].pSlots[m_used++];
+}
+
+/**
+ * Gives the memory of a node back. It is put into the free list.
+ * @param pMemory       Memory which was taken with allocate().
+ */
+template<class Node>
+void PoolNodeAllocator<Node>::deallocate(void *pMemory)
+{
+    Slot* pSlot = static_cast<Slot*>(pMemory);
+    pSlot->pNext = m_pFreeList;
+    m_pFreeList = pSlot;
+}
+
+/**
+ * All nodes are given back at once. The slabs are kept for reuse.
+ * Nodes must be destroyed before if they have a destructor.
+ */
+template<class Node>
+void PoolNodeAllocator<Node>::reset()
+{
+    m_pFreeList = 0;
+    m_currentSlab = 0;
+    m_used = 0;
+}
+
+/**
+ * Makes sure that the next count nodes are taken from one slab one
+ * after another. If the current slab has not enough unused slots a
+ * slab with count slots is inserted after it. The rest of the current
+ * slab is not used before reset().
+ * Nodes in the free list are still taken first.
+ * @param count         The number of nodes.
+ */
+template<class Node>
+void PoolNodeAllocator<Node>::reserve(const int count)
+{
+    if (m_currentSlab < m_slabs.size() && m_slabs[m_currentSlab].capacity - m_used >= count) {
+        return;
+    }
+    size_t position = m_slabs.empty() ? 0 : m_currentSlab + 1;
+    if (position < m_slabs.size() && m_slabs[position].capacity >= count) {
+        m_currentSlab = position;
+        m_used = 0;
+        return;
+    }
+    addSlab(count > SlabSize ? count : SlabSize, position);
+    m_currentSlab = position;
+    m_used = 0;
+}
+
+/**
+ * Private
+ * Allocates a new slab and inserts it into the list of slabs.
+ * @param capacity      The number of nodes in the slab.
+ * @param position      The position in the list of slabs.
+ */
+template<class Node>
+void PoolNodeAllocator<Node>::addSlab(const int capacity, const size_t position)
+{
+    Slab slab;
+    slab.pSlots = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity));
+    slab.capacity = capacity;
+    m_slabs.insert(m_slabs.begin() + position, slab);
+}
+
+
+/**
+ * ---------------------------------------------------------------------------------
+ * Template class:      NodeArrayAllocator
+ * ---------------------------------------------------------------------------------
+ * Gives memory for arrays of 1 to MaxCount elements. There is one allocator policy
+ * for each size class of 1, 2, 4, 8 and 16 elements. An array takes the memory of
+ * the least size class it fits in. So arrays come from the same kind of memory as
+ * the nodes. With the PoolNodeAllocator they are taken from slabs and reset()
+ * releases all of them at once.
+ * An array of more than MaxCount elements does not fit into a size class. It is
+ * taken from the heap and kept in a list. So reset() and the destructor release
+ * it too.
+ * The elements must be trivially destructible. allocate() constructs them with
+ * their default constructor.
+ */
+template<class Element, template<class> class Allocator>
+class NodeArrayAllocator
+{
+    static_assert(std::is_trivially_destructible<Element>::value, "Array elements must be trivially destructible.");
+
+public:
+    enum { MaxCount = 16, CanReset = Allocator<Element>::CanReset };
+
+    /**
+     * Destructor
+     * Deletes the arrays which are larger than MaxCount.
+     */
+    ~NodeArrayAllocator()
+    {
+        releaseLargeArrays();
+    }
+
+    Element* allocate(const int count);
+    void deallocate(Element* pArray, const int count);
+    void reset();
+
+private:
+    void releaseLargeArrays();
+
+private:
+    // The memory of one array in a size class.
+    template<int Count>
+    struct Block {
+        Element elements[Count];
+    };
+
+private:
+    Allocator<Block<1> > m_allocator1;
+    Allocator<Block<2> > m_allocator2;
+    Allocator<Block<4> > m_allocator4;
+    Allocator<Block<8> > m_allocator8;
+    Allocator<Block<16> > m_allocator16;
+    // Arrays with more than MaxCount elements.
+    std::vector<Element*> m_largeArrays;
+};
+
+/**
+ * Get memory for an array from its size class. An array of more than
+ * MaxCount elements is taken from the heap.
+ * @param count         The number of elements.
+ * @return              The array with default constructed elements.
+ */
+template<class Element, template<class> class Allocator>
+Element *NodeArrayAllocator<Element, Allocator>::allocate(const int count)
+{
+    void* pMemory = 0;
+    if (count <= 1) {
+        pMemory = m_allocator1.allocate();
+    } else if (count <= 2) {
+        pMemory = m_allocator2.allocate();
+    } else if (count <= 4) {
+        pMemory = m_allocator4.allocate();
+    } else if (count <= 8) {
+        pMemory = m_allocator8.allocate();
+    } else if (count <= MaxCount) {
+        pMemory = m_allocator16.allocate();
+    } else {
+        pMemory = ::operator new(sizeof(Element) * count);
+        m_largeArrays.push_back(static_cast<Element*>(pMemory));
+    }
+    Element* pArray = static_cast<Element*>(pMemory);
+    for (int index=0; index<count; ++index) {
+        new (pArray + index) Element();
+    }
+
+    return pArray;
+}
+
+/**
+ * Gives the memory of an array back to its size class.
+ * @param pArray        An array from allocate().
+ * @param count         The number of elements which was given to allocate().
+ */
+template<class Element, template<class> class Allocator>
+void NodeArrayAllocator<Element, Allocator>::deallocate(Element *pArray, const int count)
+{
+    if (count <= 1) {
+        m_allocator1.deallocate(pArray);
+    } else if (count <= 2) {
+        m_allocator2.deallocate(pArray);
+    } else if (count <= 4) {
+        m_allocator4.deallocate(pArray);
+    } else if (count <= 8) {
+        m_allocator8.deallocate(pArray);
+    } else if (count <= MaxCount) {
+        m_allocator16.deallocate(pArray);
+    } else {
+        m_largeArrays.erase(std::find(m_largeArrays.begin(), m_largeArrays.end(), pArray));
+        ::operator delete(pArray);
+    }
+}
+
+/**
+ * All arrays of all size classes and all large arrays are given back
+ * at once.
+ */
+template<class Element, template<class> class Allocator>
+void NodeArrayAllocator<Element, Allocator>::reset()
+{
+    m_allocator1.reset();
+    m_allocator2.reset();
+    m_allocator4.reset();
+    m_allocator8.reset();
+    m_allocator16.reset();
+    releaseLargeArrays();
+}
+
+/**
+ * Private
+ * Deletes all arrays which are larger than MaxCount.
+ */
+template<class Element, template<class> class Allocator>
+void NodeArrayAllocator<Element, Allocator>::releaseLargeArrays()
+{
+    for (size_t index=0; index<m_largeArrays.size(); ++index) {
+        ::operator delete(m_largeArrays[index]);
+    }
+    m_largeArrays.clear();
+}
+
+#endif // NODEALLOCATOR_H
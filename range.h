@@ -0,0 +1,48 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+
+/**
+ * ---------------------------------------------------------------------------------
+ * Class:               Range
+ * ---------------------------------------------------------------------------------
+ * A closed range of array indexes from start to end. It is used by the binary
+ * search in BinarySearchArray. The search moves start or end towards the median
+ * until the object is found or the range is not valid anymore.
+ */
+class Range
+{
+public:
+    /**
+     * Constructs a range over a whole array. The range of an empty
+     * array is not valid.
+     * @param length        The number of elements in the array.
+     */
+    explicit Range(const int length) :
+        m_start(0),
+        m_end(length - 1)
+    {
+    }
+
+    /**
+     * A range is valid as long as start is not behind end.
+     * @return              True if the range has at least one index.
+     */
+    bool isValid() const                        { return m_start <= m_end; }
+    /**
+     * Get the index in the middle of the range. It does not overflow with
+     * large indexes.
+     * @return              The median index.
+     */
+    int median() const                          { return m_start + (m_end - m_start) / 2; }
+    int start() const                           { return m_start; }
+    int end() const                             { return m_end; }
+    void setStart(const int start)              { m_start = start; }
+    void setEnd(const int end)                  { m_end = end; }
+
+private:
+    int m_start;
+    int m_end;
+};
+
+#endif // RANGE_H
@@ -0,0 +1,266 @@
+#ifndef SORTEDVECTOR_H
+#define SORTEDVECTOR_H
+
+#include "binarysearcharray.h"
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+
+/**
+ * -------------------------------------------------------------------------------------
+ * Template class:          SortedVector
+ * -------------------------------------------------------------------------------------
+ * A sorted container with contiguous storage. It is an alternative to SortList for
+ * data which is read much more often than it is changed. Elements are kept in one
+ * std::vector in ascending order. Lookups are binary searches.
+ * The data object must handle the operators <, == and >. The EqualBehaviour is the
+ * same as in SortList. To unite data elements you must '#define CanUniteData' before
+ * include this header file.
+ *
+ * Insert
+ * ------
+ * insert() puts one element at its place at once. It moves all greater elements. So
+ * many single inserts are O(n) each. append() and appendRange() only collect new
+ * elements. They are sorted and merged with the vector at the next read access in
+ * one pass. The result is the same as inserting them one by one.
+ *
+ * Move semantics
+ * --------------
+ * insert(T&&) and append(T&&) move the data object into the container. emplace()
+ * constructs the data object from its arguments first and moves it to its place.
+ * The object is needed to find the place. And std::vector can not construct an
+ * element in the middle in place. Elements are moved when they are merged. takeVector() moves all elements out.
+ * The move constructor of T should be noexcept. Else std::vector copies all
+ * elements when it grows.
+ *
+ * Views
+ * -----
+ * toArray() returns a pointer into the vector and searchArray() a BinarySearchArray
+ * on the same memory. Nothing is copied. Both are valid until the next change of the
+ * container. Read access merges collected elements. So it is not safe to read from
+ * more than one thread while elements are collected.
+ */
+template<class T>
+class SortedVector
+{
+public:
+    enum EqualBehaviour { UniteNodeData, InsertDoublicate, DropDoublicate };
+
+    /**
+     * Constructs a SortedVector with standard behaviour.
+     */
+    SortedVector() :
+        m_equalBehaviour(InsertDoublicate)
+    {
+
+    }
+
+    /**
+     * Constructs a SortedVector with a given behaviour.
+     * @param behaviour     Behaviour when a duplicate was found (equal object).
+     */
+    SortedVector(EqualBehaviour behaviour) :
+        m_equalBehaviour(behaviour)
+    {
+
+    }
+
+    void clear()                                        { m_data.clear(); m_pending.clear(); }
+    int insert(const T& data)                           { return insertValue(data); }
+    int insert(T&& data)                                { return insertValue(std::move(data)); }
+    template<class... Args>
+    int emplace(Args&&... args)                         { return insertValue(T(std::forward<Args>(args)...)); }
+    void append(const T& data)                          { m_pending.push_back(data); }
+    void append(T&& data)                               { m_pending.push_back(std::move(data)); }
+    template<class Iterator>
+    void appendRange(Iterator first, Iterator last)     { m_pending.insert(m_pending.end(), first, last); }
+    void reserve(const int size)                        { m_data.reserve(size); }
+    bool isEmpty() const                                { return size() == 0; }
+    int size() const                                    { mergePending(); return m_data.size(); }
+    const T& at(const int index) const                  { mergePending(); return m_data[index]; }
+    int lowerBound(const T& data) const;
+    int indexOf(const T& data) const;
+    const T* find(const T& data) const;
+    const T* toArray() const                            { mergePending(); return m_data.empty() ? 0 : m_data.data(); }
+    BinarySearchArray<T> searchArray() const;
+    std::vector<T> takeVector();
+    void setEqualBehaviour(const EqualBehaviour behaviour)      { mergePending(); m_equalBehaviour = behaviour; }
+
+private:
+    template<class Value>
+    int insertValue(Value&& data);
+    void mergePending() const;
+
+private:
+    mutable std::vector<T> m_data;
+    mutable std::vector<T> m_pending;
+    EqualBehaviour m_equalBehaviour;
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Definition
+
+/**
+ * Inserts a new data object at once. The element will be placed so that
+ * the vector is sorted ascending. An equal element is handled like in
+ * SortList::insert(). An rvalue data object is moved into the vector.
+ * @param data          A data object.
+ * @return position     The position where the new element is inserted.
+ */
+template<class T>
+template<class Value>
+int SortedVector<T>::insertValue(Value&& data)
+{
+    int position = lowerBound(data);
+    if (position < (int)m_data.size() && m_data[position] == data) {
+        switch (m_equalBehaviour) {
+        case UniteNodeData:
+#ifdef CanUniteData
+            m_data[position] << data;
+#endif
+            return position;
+        case InsertDoublicate:
+            break;
+        case DropDoublicate:
+            return position;
+        }
+    }
+    m_data.insert(m_data.begin() + position, std::forward<Value>(data));
+
+    return position;
+}
+
+/**
+ * Binary search for the first element which is not lesser than data.
+ * @param data          A data object to search for.
+ * @return              An index between 0 and size().
+ */
+template<class T>
+int SortedVector<T>::lowerBound(const T& data) const
+{
+    mergePending();
+
+    return std::lower_bound(m_data.begin(), m_data.end(), data) - m_data.begin();
+}
+
+/**
+ * Get the index of the first element which is equal to data.
+ * @param data          A data object to search for.
+ * @return              The index or -1 if there is no equal element.
+ */
+template<class T>
+int SortedVector<T>::indexOf(const T& data) const
+{
+    int position = lowerBound(data);
+    if (position < (int)m_data.size() && m_data[position] == data) {
+        return position;
+    }
+
+    return -1;
+}
+
+/**
+ * Find the first element which is equal to data.
+ * @param data          A data object to search for.
+ * @return              A pointer to the element or null.
+ */
+template<class T>
+const T* SortedVector<T>::find(const T& data) const
+{
+    int position = indexOf(data);
+
+    return position < 0 ? 0 : &m_data[position];
+}
+
+/**
+ * Get a BinarySearchArray on the elements of this container. The array
+ * is not copied. The BinarySearchArray does not take ownership.
+ * @return              A BinarySearchArray object.
+ */
+template<class T>
+BinarySearchArray<T> SortedVector<T>::searchArray() const
+{
+    mergePending();
+
+    return BinarySearchArray<T>(m_data.empty() ? 0 : m_data.data(), m_data.size(), false);
+}
+
+/**
+ * Moves all elements out of the container. The elements are not copied.
+ * The container is empty afterwards.
+ * @return              A vector with the sorted elements.
+ */
+template<class T>
+std::vector<T> SortedVector<T>::takeVector()
+{
+    mergePending();
+    std::vector<T> data;
+    data.swap(m_data);
+
+    return data;
+}
+
+/**
+ * Private
+ * Sorts the collected elements and merges them with the vector in one
+ * pass. Equal elements are handled like in SortList::insertRange().
+ */
+template<class T>
+void SortedVector<T>::mergePending() const
+{
+    if (m_pending.empty()) {
+        return;
+    }
+    std::stable_sort(m_pending.begin(), m_pending.end());
+    std::vector<T> result;
+    result.reserve(m_data.size() + m_pending.size());
+    size_t index = 0;
+    size_t runStart = 0;
+    while (runStart < m_pending.size()) {
+        // A run of equal objects in the collected elements.
+        size_t runEnd = runStart + 1;
+        while (runEnd < m_pending.size() && m_pending[runEnd] == m_pending[runStart]) {
+            ++runEnd;
+        }
+        while (index < m_data.size() && m_data[index] < m_pending[runStart]) {
+            result.push_back(std::move(m_data[index++]));
+        }
+        bool hasEqual = index < m_data.size() && m_data[index] == m_pending[runStart];
+        switch (m_equalBehaviour) {
+        case UniteNodeData:
+        {
+            size_t runIndex = runStart;
+            if (hasEqual) {
+                result.push_back(std::move(m_data[index++]));
+            } else {
+                result.push_back(std::move(m_pending[runIndex++]));
+            }
+#ifdef CanUniteData
+            for (; runIndex<runEnd; ++runIndex) {
+                result.back() << m_pending[runIndex];
+            }
+#endif
+            break;
+        }
+        case InsertDoublicate:
+            // Each new element would be inserted before the last one.
+            for (size_t runIndex=runEnd; runIndex>runStart; --runIndex) {
+                result.push_back(std::move(m_pending[runIndex - 1]));
+            }
+            break;
+        case DropDoublicate:
+            if (! hasEqual) {
+                result.push_back(std::move(m_pending[runStart]));
+            }
+            break;
+        }
+        runStart = runEnd;
+    }
+    result.insert(result.end(), std::make_move_iterator(m_data.begin() + index), std::make_move_iterator(m_data.end()));
+    m_data.swap(result);
+    m_pending.clear();
+}
+
+#endif // SORTEDVECTOR_H
@@ -1,8 +1,14 @@
 #ifndef SORTLIST_H
 #define SORTLIST_H
 
+#include "nodeallocator.h"
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+#include <utility>
 
-template<class T> class SortList;
+
+template<class T, template<class> class Allocator = HeapNodeAllocator> class SortList;
 template<class T> class SortListIterator;
 
 
@@ -13,11 +19,15 @@ template<class T> class SortListIterator;
  * A node for the linked list which sorts the inserted elments. The ListNode
  * class takes any data type. But the data object must handle the operators <, ==
  * and >. These operators are used for sorting.
+ * m_previous and m_next link all nodes (level 0 of the skip list). A node on
+ * higher levels of the skip list has a tower with one link for each level
+ * above level 0. The tower is NULL for most nodes. m_towerSize is the number
+ * of links in the tower.
  */
 template<class T>
 class ListNode
 {
-    friend class SortList<T>;
+    template<class, template<class> class> friend class SortList;
     friend class SortListIterator<T>;
 
 public:
@@ -29,7 +39,9 @@ public:
     ListNode(const T& data) :
         m_data(data),
         m_previous(0),
-        m_next(0)
+        m_next(0),
+        m_pTower(0),
+        m_towerSize(0)
     {
 
     }
@@ -44,15 +56,61 @@ public:
     ListNode(ListNode<T>* prev, const T& data, ListNode<T>* next) :
         m_previous(prev),
         m_data(data),
-        m_next(next)
+        m_next(next),
+        m_pTower(0),
+        m_towerSize(0)
+    {
+
+    }
+
+    /**
+     * Constructs a ListNode object and moves the data object into it.
+     * @param prev          Pointer to a previous list node.
+     * @param data          The data object of this node. It is moved.
+     * @param next          Pointer to the following list node.
+     */
+    ListNode(ListNode<T>* prev, T&& data, ListNode<T>* next) :
+        m_previous(prev),
+        m_data(std::move(data)),
+        m_next(next),
+        m_pTower(0),
+        m_towerSize(0)
+    {
+
+    }
+
+    // Selects the constructor which constructs the data object in the node.
+    struct InPlace {};
+
+    /**
+     * Constructs a ListNode object and its data object from the arguments.
+     * No data object is copied or moved. Pointer to previous and next node
+     * are null.
+     * @param args          The arguments of a constructor of T.
+     */
+    template<class... Args>
+    ListNode(InPlace, Args&&... args) :
+        m_previous(0),
+        m_data(std::forward<Args>(args)...),
+        m_next(0),
+        m_pTower(0),
+        m_towerSize(0)
     {
 
     }
 
+    // A link on a level above level 0. Width is the number of positions to the next node.
+    struct SkipLink {
+        ListNode<T>* pNext;
+        int width;
+    };
+
 protected:
     ListNode<T>* m_previous;
     T m_data;
     ListNode<T>* m_next;
+    SkipLink* m_pTower;
+    int m_towerSize;
 };
 
 
@@ -64,14 +122,23 @@ protected:
  * where is should take place to make the list soted. The list elements are sorted
  * ascending. To get the elements descending get a iterator with end(). Iterate backwards
  * through the list.
+ * The list is an indexable skip list. All nodes are linked in both directions. About
+ * every fourth node is linked on level 1 too, every 16th on level 2 and so on. Each
+ * link knows how many positions it skips. So insert() finds the position of a new
+ * element in O(log n) and knows its index.
+ * The list nodes and the towers of the skip list are allocated by the Allocator policy
+ * (see nodeallocator.h). With the PoolNodeAllocator nodes and towers are taken from
+ * large slabs and clear() releases all of them at once. Nodes are only destroyed one
+ * by one if T has a destructor.
  */
-template<class T>
+template<class T, template<class> class Allocator>
 class SortList
 {
 public:
 
     enum NodeCompareResult { Lesser = -1, Equal = 0, Greater = 1 };
     enum EqualBehaviour { UniteNodeData, InsertDoublicate, DropDoublicate };
+    enum { MaxLevel = 16 };
 
 
     /**
@@ -81,7 +148,9 @@ public:
         m_pHead(0),
         m_pTail(0),
         m_size(0),
-        m_equalBehaviour(InsertDoublicate)
+        m_equalBehaviour(InsertDoublicate),
+        m_level(1),
+        m_randomState(0x9E3779B9u)
     {
 
     }
@@ -94,7 +163,9 @@ public:
         m_pHead(0),
         m_pTail(0),
         m_size(0),
-        m_equalBehaviour(behaviour)
+        m_equalBehaviour(behaviour),
+        m_level(1),
+        m_randomState(0x9E3779B9u)
     {
 
     }
@@ -109,24 +180,50 @@ public:
     }
 
     void clear();
-    int insert(const T& data);
+    int insert(const T& data)                           { return insertValue(data); }
+    int insert(T&& data)                                { return insertValue(std::move(data)); }
+    template<class... Args>
+    int emplace(Args&&... args);
+    template<class Iterator>
+    int insertRange(Iterator first, Iterator last);
     bool isEmpty() const                                { return m_pHead == 0; }
     int size() const                                    { return m_size; }
     T* toArray() const;
+    std::vector<T> takeVector();
     SortListIterator<T> begin() const                  { return SortListIterator<T>(m_pHead); }
     SortListIterator<T> end() const                    { return SortListIterator<T>(m_pTail); }
     void setEqualBehaviour(const EqualBehaviour behaviour)      { m_equalBehaviour = behaviour; }
 
 private:
+    typedef typename ListNode<T>::SkipLink SkipLink;
+
     NodeCompareResult compare(const T& data, const ListNode<T>* const pNode) const;
-    void insertBefore(const T &data, ListNode<T>* pNode);
     void insertEqual(const T& data, ListNode<T>* pNode);
+    template<class Value>
+    int insertValue(Value&& data);
+    int findPosition(const T& data, ListNode<T>** update, int* rank, ListNode<T>*& pNode);
+    void linkNode(ListNode<T>* pNewNode, ListNode<T>** update, int* rank, const int position);
+    template<class Value>
+    ListNode<T>* createNode(ListNode<T>* prev, Value&& data, ListNode<T>* next);
+    void destroyNode(ListNode<T>* pNode);
+    void createTower(ListNode<T>* pNode, const int size);
+    void destroyTower(ListNode<T>* pNode);
+    SkipLink& link(ListNode<T>* pNode, const int level)    { return pNode ? pNode->m_pTower[level - 1] : m_headLinks[level - 1]; }
+    int randomLevel();
+    void linkBefore(ListNode<T>* pNewNode, ListNode<T>* pNode);
+    void rebuildTowers();
 
 private:
     ListNode<T>* m_pHead;
     ListNode<T>* m_pTail;
     int m_size;
     EqualBehaviour m_equalBehaviour;
+    // Links of the list head on levels above level 0. Level 0 is m_pHead.
+    SkipLink m_headLinks[MaxLevel - 1];
+    int m_level;
+    unsigned int m_randomState;
+    Allocator<ListNode<T> > m_allocator;
+    NodeArrayAllocator<SkipLink, Allocator> m_towerAllocator;
 };
 
 
@@ -137,8 +234,8 @@ private:
  * An iterator class to iterate through the SortList elements. It has a private
  * constructor and can not be instantiated manualy. The SortList methods begin()
  * and end() returns a instance of this class.
- * You can get a copy of the data object with data() and iterate with next() and
- * previous() through the SortList elements.
+ * data() returns a const reference to the data object in the list. Nothing is
+ * copied. Iterate with next() and previous() through the SortList elements.
  * The returned iterator from list has the first element. Call next() or previous()
  * to get another element.
  * If the iterator reaches the end of the list it returns 'false' and keeps its
@@ -147,7 +244,7 @@ private:
 template<class T>
 class SortListIterator
 {
-    friend class SortList<T>;
+    template<class, template<class> class> friend class SortList;
 
 private:
     SortListIterator(ListNode<T>* pNode)            { m_pNode = pNode; }
@@ -167,9 +264,9 @@ public:
     bool previous()             { if (m_pNode == 0 || m_pNode->m_previous == 0) return false; m_pNode = m_pNode->m_previous; return true; }
     /**
      * Get the data object of the ierators position.
-     * @return      The data object of iterators position.
+     * @return      A reference to the data object of iterators position.
      */
-    T data() const              { return m_pNode->m_data; }
+    const T& data() const       { return m_pNode->m_data; }
 
 private:
     ListNode<T>* m_pNode;
@@ -180,20 +277,26 @@ private:
 
 /**
  * Removes all elements from teh list.
- * Delete all objects from the heap memory.
+ * Delete all objects from the heap memory. If the allocator can release
+ * all nodes and towers at once and T has no destructor no node is visited.
  */
-template<class T>
-void SortList<T>::clear()
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::clear()
 {
-    ListNode<T>* pNode = m_pHead;
-    ListNode<T>* pTempNode = 0;
-    while (pNode != 0) {
-        pTempNode = pNode;
-        pNode = pNode->m_next;
-        delete pTempNode;
+    if (! Allocator<ListNode<T> >::CanReset || ! std::is_trivially_destructible<T>::value) {
+        ListNode<T>* pNode = m_pHead;
+        ListNode<T>* pTempNode = 0;
+        while (pNode != 0) {
+            pTempNode = pNode;
+            pNode = pNode->m_next;
+            destroyNode(pTempNode);
+        }
     }
+    m_allocator.reset();
+    m_towerAllocator.reset();
     m_pHead = m_pTail = 0;
     m_size = 0;
+    m_level = 1;
 }
 
 /**
@@ -204,8 +307,8 @@ void SortList<T>::clear()
  * @param pNode         A list node object.
  * @return              Lesser if data is lesser. Equal if both are equal. Else Grater.
  */
-template<class T>
-typename SortList<T>::NodeCompareResult SortList<T>::compare(const T& data, const ListNode<T>* const pNode) const
+template<class T, template<class> class Allocator>
+typename SortList<T, Allocator>::NodeCompareResult SortList<T, Allocator>::compare(const T& data, const ListNode<T>* const pNode) const
 {
     if (data < pNode->m_data) {
         return Lesser;
@@ -220,80 +323,234 @@ typename SortList<T>::NodeCompareResult SortList<T>::compare(const T& data, cons
 /**
  * Inserts a new data object into the list. The element will be placed so that
  * the list is sorted ascending.
+ * insert(T&&) moves the data object into the new node. No node is created if
+ * an equal element takes the data.
  * @param data          A data object.
  * @return position     The position where the new element is inserted.
  */
-template<class T>
-int SortList<T>::insert(const T& data)
+template<class T, template<class> class Allocator>
+template<class Value>
+int SortList<T, Allocator>::insertValue(Value&& data)
 {
-    if (isEmpty()) {
-        m_pHead = m_pTail = new ListNode<T>(data);
-        m_size = 1;
+    ListNode<T>* update[MaxLevel];
+    int rank[MaxLevel];
+    ListNode<T>* pNode = 0;
+    int position = findPosition(data, update, rank, pNode);
+    ListNode<T>* pNextNode = pNode ? pNode->m_next : m_pHead;
+    if (pNextNode != 0 && m_equalBehaviour != InsertDoublicate && compare(data, pNextNode) == Equal) {
+        insertEqual(data, pNextNode);
+        return position;
+    }
+    linkNode(createNode(pNode, std::forward<Value>(data), pNextNode), update, rank, position);
 
-        return 0;
+    return position;
+}
+
+/**
+ * Constructs a new data object from the arguments in a new node. The node
+ * is inserted like with insert(). The data object is not copied or moved.
+ * The node is created before the position is searched. So it is destroyed
+ * again if an equal element takes the data.
+ * @param args          The arguments of a constructor of T.
+ * @return position     The position where the new element is inserted.
+ */
+template<class T, template<class> class Allocator>
+template<class... Args>
+int SortList<T, Allocator>::emplace(Args&&... args)
+{
+    ListNode<T>* pNewNode = new (m_allocator.allocate()) ListNode<T>(typename ListNode<T>::InPlace(),
+                                                                     std::forward<Args>(args)...);
+    ListNode<T>* update[MaxLevel];
+    int rank[MaxLevel];
+    ListNode<T>* pNode = 0;
+    int position = findPosition(pNewNode->m_data, update, rank, pNode);
+    ListNode<T>* pNextNode = pNode ? pNode->m_next : m_pHead;
+    if (pNextNode != 0 && m_equalBehaviour != InsertDoublicate && compare(pNewNode->m_data, pNextNode) == Equal) {
+        insertEqual(pNewNode->m_data, pNextNode);
+        destroyNode(pNewNode);
+        return position;
     }
-    int position = 0;
-    ListNode<T>* pNode = m_pHead;
-    while (pNode != 0) {
-        NodeCompareResult compareResult = compare(data, pNode);
-        switch (compareResult) {
-        case Lesser:
-            insertBefore(data, pNode);
-            return position;
-            break;
-        case Equal:
-            insertEqual(data, pNode);
-            return position;
-            break;
-        case Greater:
-            break;
+    pNewNode->m_previous = pNode;
+    pNewNode->m_next = pNextNode;
+    linkNode(pNewNode, update, rank, position);
+
+    return position;
+}
+
+/**
+ * Private
+ * Searches the position of a new data object.
+ * The skip list is searched from the highest level down to level 0. On each
+ * level the last node before the new element and its position are kept.
+ * @param data          The new data object.
+ * @param update        Is set to the last node before the new element on each
+ *                      level above level 0. NULL is the head of the list.
+ * @param rank          Is set to the positions of the nodes in update.
+ * @param pNode         Is set to the last node before the new element on level 0.
+ * @return              The position of the new element.
+ */
+template<class T, template<class> class Allocator>
+int SortList<T, Allocator>::findPosition(const T& data, ListNode<T>** update, int* rank, ListNode<T>*& pNode)
+{
+    // A NULL node is the head of the list at position -1.
+    pNode = 0;
+    int position = -1;
+    for (int level=m_level-1; level>0; --level) {
+        SkipLink* pLink = &link(pNode, level);
+        while (pLink->pNext != 0 && compare(data, pLink->pNext) == Greater) {
+            position += pLink->width;
+            pNode = pLink->pNext;
+            pLink = &link(pNode, level);
         }
+        update[level] = pNode;
+        rank[level] = position;
+    }
+    ListNode<T>* pNextNode = pNode ? pNode->m_next : m_pHead;
+    while (pNextNode != 0 && compare(data, pNextNode) == Greater) {
+        pNode = pNextNode;
+        pNextNode = pNextNode->m_next;
         ++position;
-        pNode = pNode->m_next;
     }
-    pNode = new ListNode<T>(m_pTail, data, 0);
-    m_pTail->m_next = pNode;
-    m_pTail = pNode;
-    ++m_size;
 
-    return m_size - 1;
+    return position + 1;
 }
 
 /**
- * Insert the new element before the given list node.
- * @param data          The new data object to insert.
- * @param pNode         The list node where the new element should be placed before.
+ * Private
+ * Links a new node at the position from findPosition(). The new node is
+ * linked behind the nodes in update on its levels. Links above its levels
+ * skip one more position afterwards.
+ * @param pNewNode      The new node. Its previous and next node are set.
+ * @param update        The nodes from findPosition().
+ * @param rank          The positions from findPosition().
+ * @param position      The position of the new node.
  */
-template<class T>
-void SortList<T>::insertBefore(const T& data, ListNode<T>* pNode)
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::linkNode(ListNode<T>* pNewNode, ListNode<T>** update, int* rank, const int position)
 {
-    ListNode<T>* pNewNode = new ListNode<T>(pNode->m_previous, data, pNode);
-    if (m_pHead == pNode) {
+    // Link the new node on level 0.
+    if (pNewNode->m_previous == 0) {
         m_pHead = pNewNode;
     } else {
-        ListNode<T>* pPrevNode = pNode->m_previous;
-        pPrevNode->m_next = pNewNode;
+        pNewNode->m_previous->m_next = pNewNode;
+    }
+    if (pNewNode->m_next == 0) {
+        m_pTail = pNewNode;
+    } else {
+        pNewNode->m_next->m_previous = pNewNode;
     }
-    pNode->m_previous = pNewNode;
     ++m_size;
+    // Link the new node on higher levels.
+    int nodeLevel = randomLevel();
+    if (nodeLevel > 1) {
+        createTower(pNewNode, nodeLevel - 1);
+    }
+    for (; m_level<nodeLevel; ++m_level) {
+        update[m_level] = 0;
+        rank[m_level] = -1;
+        m_headLinks[m_level - 1].pNext = 0;
+        m_headLinks[m_level - 1].width = m_size;
+    }
+    for (int level=1; level<nodeLevel; ++level) {
+        SkipLink& previousLink = link(update[level], level);
+        SkipLink& newLink = pNewNode->m_pTower[level - 1];
+        newLink.pNext = previousLink.pNext;
+        newLink.width = previousLink.width - (position - rank[level]) + 1;
+        previousLink.pNext = pNewNode;
+        previousLink.width = position - rank[level];
+    }
+    for (int level=nodeLevel; level<m_level; ++level) {
+        ++link(update[level], level).width;
+    }
 }
 
 /**
- * Insert a equal element into the list. If a equal list element is found than
- * there are three posibilities to handle that. If 'InsertDoublicates' is set
- * as list behaviour then the new element is set above of the equal element.
- * If equal behaviour is set to 'DropDoublicates than the element won't be
+ * Inserts many data objects at once. The objects are copied and sorted
+ * first. Then they are merged with the list in one pass over level 0.
+ * Afterwards the skip list levels are built again. This is O(m log m + n)
+ * for m new and n existing elements.
+ * The result is the same as inserting the objects one by one in the
+ * order of the range. Equal objects are handled by the equal behaviour.
+ * With 'InsertDoublicate' equal objects are placed in reverse order
+ * before existing equal elements.
+ * @param first         An iterator to the first data object.
+ * @param last          An iterator behind the last data object.
+ * @return              The number of new list elements.
+ */
+template<class T, template<class> class Allocator>
+template<class Iterator>
+int SortList<T, Allocator>::insertRange(Iterator first, Iterator last)
+{
+    std::vector<T> batch(first, last);
+    if (batch.empty()) {
+        return 0;
+    }
+    std::stable_sort(batch.begin(), batch.end());
+    int oldSize = m_size;
+    ListNode<T>* pNode = m_pHead;
+    size_t runStart = 0;
+    while (runStart < batch.size()) {
+        // A run of equal objects in the batch.
+        size_t runEnd = runStart + 1;
+        while (runEnd < batch.size() && batch[runEnd] == batch[runStart]) {
+            ++runEnd;
+        }
+        while (pNode != 0 && compare(batch[runStart], pNode) == Greater) {
+            pNode = pNode->m_next;
+        }
+        bool hasEqualNode = pNode != 0 && compare(batch[runStart], pNode) == Equal;
+        switch (m_equalBehaviour) {
+        case UniteNodeData:
+        {
+            size_t index = runStart;
+            ListNode<T>* pEqualNode = pNode;
+            if (! hasEqualNode) {
+                pEqualNode = createNode(0, std::move(batch[index]), 0);
+                linkBefore(pEqualNode, pNode);
+                ++index;
+            }
+#ifdef CanUniteData
+            for (; index<runEnd; ++index) {
+                pEqualNode->m_data << batch[index];
+            }
+#endif
+            break;
+        }
+        case InsertDoublicate:
+            // Each new element would be inserted before the last one.
+            for (size_t index=runEnd; index>runStart; --index) {
+                linkBefore(createNode(0, std::move(batch[index - 1]), 0), pNode);
+            }
+            break;
+        case DropDoublicate:
+            if (! hasEqualNode) {
+                linkBefore(createNode(0, std::move(batch[runStart]), 0), pNode);
+            }
+            break;
+        }
+        runStart = runEnd;
+    }
+    rebuildTowers();
+
+    return m_size - oldSize;
+}
+
+/**
+ * Handles an equal element if it is not inserted as a doublicate. If
+ * equal behaviour is set to 'DropDoublicates than the element won't be
  * set to the list.
- * The third method is 'UniteNodeData'. This will unite the content of the
+ * The other method is 'UniteNodeData'. This will unite the content of the
  * equal elements. But it requires the << operator in the data object to be
  * overriden. The overriding method must handle the merge of the elements.
  * Important: To unite data elements you must '#define CanUniteData' before
  *            include this header file.
+ * With 'InsertDoublicate' the new element is linked before the equal
+ * element by insert().
  * @param data
  * @param pNode
  */
-template<class T>
-void SortList<T>::insertEqual(const T& data, ListNode<T>* pNode)
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::insertEqual(const T& data, ListNode<T>* pNode)
 {
     switch (m_equalBehaviour) {
     case UniteNodeData:
@@ -302,8 +559,6 @@ void SortList<T>::insertEqual(const T& data, ListNode<T>* pNode)
 #endif
         break;
     case InsertDoublicate:
-        insertBefore(data, pNode);
-        break;
     case DropDoublicate:
         // Do not insert this data.
         break;
@@ -315,8 +570,8 @@ void SortList<T>::insertEqual(const T& data, ListNode<T>* pNode)
  * the heap and MUST be deleted by the user.
  * @return array        An array with the sorted list elements.
  */
-template<class T>
-T* SortList<T>::toArray() const
+template<class T, template<class> class Allocator>
+T* SortList<T, Allocator>::toArray() const
 {
     if (isEmpty()) {
         return 0;
@@ -333,4 +588,168 @@ T* SortList<T>::toArray() const
     return array;
 }
 
+/**
+ * Moves the list elements into a vector and clears the list. Each
+ * element is move constructed in the vector. No element is default
+ * constructed or copied.
+ * @return              A vector with the sorted list elements.
+ */
+template<class T, template<class> class Allocator>
+std::vector<T> SortList<T, Allocator>::takeVector()
+{
+    std::vector<T> elements;
+    elements.reserve(m_size);
+    for (ListNode<T>* pNode = m_pHead; pNode != 0; pNode = pNode->m_next) {
+        elements.push_back(std::move(pNode->m_data));
+    }
+    clear();
+
+    return elements;
+}
+
+/**
+ * Private
+ * Constructs a list node in memory of the allocator.
+ * @param prev          Pointer to a previous list node.
+ * @param data          The data object of the node.
+ * @param next          Pointer to the following list node.
+ * @return              The new list node.
+ */
+template<class T, template<class> class Allocator>
+template<class Value>
+ListNode<T>* SortList<T, Allocator>::createNode(ListNode<T>* prev, Value&& data, ListNode<T>* next)
+{
+    return new (m_allocator.allocate()) ListNode<T>(prev, std::forward<Value>(data), next);
+}
+
+/**
+ * Private
+ * Destroys a list node and gives its memory back to the allocator.
+ * @param pNode         The list node.
+ */
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::destroyNode(ListNode<T>* pNode)
+{
+    destroyTower(pNode);
+    pNode->~ListNode<T>();
+    m_allocator.deallocate(pNode);
+}
+
+/**
+ * Private
+ * Gives a node a tower from the tower allocator.
+ * @param pNode         A list node without tower.
+ * @param size          The number of links. One for each level above level 0.
+ */
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::createTower(ListNode<T>* pNode, const int size)
+{
+    pNode->m_pTower = m_towerAllocator.allocate(size);
+    pNode->m_towerSize = size;
+}
+
+/**
+ * Private
+ * Gives the tower of a node back to the tower allocator.
+ * @param pNode         A list node. Can be without tower.
+ */
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::destroyTower(ListNode<T>* pNode)
+{
+    if (pNode->m_pTower != 0) {
+        m_towerAllocator.deallocate(pNode->m_pTower, pNode->m_towerSize);
+        pNode->m_pTower = 0;
+        pNode->m_towerSize = 0;
+    }
+}
+
+/**
+ * Private
+ * Links a new node on level 0 before a node of the list.
+ * @param pNewNode      The new node.
+ * @param pNode         A node of the list or NULL to append the new node.
+ */
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::linkBefore(ListNode<T>* pNewNode, ListNode<T>* pNode)
+{
+    ListNode<T>* pPrevNode = pNode ? pNode->m_previous : m_pTail;
+    pNewNode->m_previous = pPrevNode;
+    pNewNode->m_next = pNode;
+    if (pPrevNode == 0) {
+        m_pHead = pNewNode;
+    } else {
+        pPrevNode->m_next = pNewNode;
+    }
+    if (pNode == 0) {
+        m_pTail = pNewNode;
+    } else {
+        pNode->m_previous = pNewNode;
+    }
+    ++m_size;
+}
+
+/**
+ * Private
+ * Builds all levels above level 0 again in one pass. Each node gets a
+ * new random level. The last node and its position on each level are
+ * kept to link the next node of this level.
+ */
+template<class T, template<class> class Allocator>
+void SortList<T, Allocator>::rebuildTowers()
+{
+    ListNode<T>* lastNode[MaxLevel];
+    int lastPosition[MaxLevel];
+    for (int level=1; level<MaxLevel; ++level) {
+        lastNode[level] = 0;
+        lastPosition[level] = -1;
+    }
+    m_level = 1;
+    int position = 0;
+    for (ListNode<T>* pNode = m_pHead; pNode != 0; pNode = pNode->m_next, ++position) {
+        destroyTower(pNode);
+        int nodeLevel = randomLevel();
+        if (nodeLevel == 1) {
+            continue;
+        }
+        createTower(pNode, nodeLevel - 1);
+        for (int level=1; level<nodeLevel; ++level) {
+            SkipLink& previousLink = link(lastNode[level], level);
+            previousLink.pNext = pNode;
+            previousLink.width = position - lastPosition[level];
+            lastNode[level] = pNode;
+            lastPosition[level] = position;
+        }
+        if (nodeLevel > m_level) {
+            m_level = nodeLevel;
+        }
+    }
+    for (int level=1; level<m_level; ++level) {
+        SkipLink& lastLink = link(lastNode[level], level);
+        lastLink.pNext = 0;
+        lastLink.width = m_size - lastPosition[level];
+    }
+}
+
+/**
+ * Private
+ * Chooses the number of levels of a new node. A node is on the next
+ * higher level with a probability of 1/4. Uses a xorshift generator.
+ * @return              A level between 1 and MaxLevel.
+ */
+template<class T, template<class> class Allocator>
+int SortList<T, Allocator>::randomLevel()
+{
+    int level = 1;
+    m_randomState ^= m_randomState << 13;
+    m_randomState ^= m_randomState >> 17;
+    m_randomState ^= m_randomState << 5;
+    unsigned int bits = m_randomState;
+    while (level < MaxLevel && (bits & 3) == 0) {
+        ++level;
+        bits >>= 2;
+    }
+
+    return level;
+}
+
 #endif // SORTLIST_H